@@ -39,6 +39,8 @@
 #include "fnmatch.h"
 #include "top.h"
 #include "filestuff.h"
+#include "gdb_dirent.h"
+#include "hashtab.h"
 
 /* The suffix of per-objfile scripts to auto-load as non-Python command files.
    E.g. When the program loads libfoo.so, look for libfoo-gdb.gdb.  */
@@ -719,6 +721,236 @@ clear_section_scripts (void)
     }
 }
 
+/* Listings of the directories searched for auto-load scripts.  The
+   scripts of every objfile are looked for in the objfile's own
+   directory and under each "set auto-load scripts-directory" entry,
+   so when many shared libraries from the same directories are loaded
+   at once, reading each directory once is much cheaper than trying to
+   open a file for each library and script language.  The listings,
+   and the cached real paths of objfiles below, are dropped before each
+   command and each prompt so that files created in the meantime are
+   found.  */
+
+struct auto_load_dir_listing
+{
+  /* The directory name, with a trailing directory separator.  */
+  char *dirname;
+
+  /* A hash table of the names in the directory.  NULL if the
+     directory could not be listed but might still contain files.  */
+  htab_t names;
+};
+
+/* A hash table of auto_load_dir_listing objects, or NULL.  */
+
+static htab_t auto_load_dir_listings;
+
+static hashval_t
+hash_auto_load_dir_listing (const void *p)
+{
+  const struct auto_load_dir_listing *listing = p;
+
+  return filename_hash (listing->dirname);
+}
+
+static int
+eq_auto_load_dir_listing (const void *a, const void *b)
+{
+  const struct auto_load_dir_listing *la = a;
+  const struct auto_load_dir_listing *lb = b;
+
+  return filename_cmp (la->dirname, lb->dirname) == 0;
+}
+
+static void
+free_auto_load_dir_listing (void *p)
+{
+  struct auto_load_dir_listing *listing = p;
+
+  xfree (listing->dirname);
+  if (listing->names != NULL)
+    htab_delete (listing->names);
+  xfree (listing);
+}
+
+/* Read the directory of LISTING into its NAMES.  */
+
+static void
+auto_load_read_dir_listing (struct auto_load_dir_listing *listing)
+{
+  DIR *dir;
+  struct dirent *dirent;
+
+  dir = opendir (listing->dirname);
+  if (dir == NULL)
+    {
+      /* A directory that does not exist has no scripts either; for
+	 other errors, such as a directory that can be searched but not
+	 read, let the caller try to open the file.  */
+      if (errno == ENOENT || errno == ENOTDIR)
+	listing->names = htab_create_alloc (1, filename_hash,
+					    filename_eq, xfree,
+					    xcalloc, xfree);
+      return;
+    }
+
+  listing->names = htab_create_alloc (64, filename_hash,
+				      filename_eq, xfree,
+				      xcalloc, xfree);
+  while ((dirent = readdir (dir)) != NULL)
+    {
+      void **slot = htab_find_slot (listing->names, dirent->d_name, INSERT);
+
+      if (*slot == NULL)
+	*slot = xstrdup (dirent->d_name);
+    }
+  closedir (dir);
+}
+
+/* Return 0 if FILENAME certainly does not exist, according to the
+   listing of its directory.  Return 1 if it may exist.  */
+
+static int
+auto_load_file_may_exist (const char *filename)
+{
+  const char *base = lbasename (filename);
+  struct auto_load_dir_listing search, *listing;
+  void **slot;
+
+  if (base == filename || *base == '\0')
+    return 1;
+
+  if (auto_load_dir_listings == NULL)
+    auto_load_dir_listings
+      = htab_create_alloc (16, hash_auto_load_dir_listing,
+			   eq_auto_load_dir_listing,
+			   free_auto_load_dir_listing, xcalloc, xfree);
+
+  search.dirname = savestring (filename, base - filename);
+  slot = htab_find_slot (auto_load_dir_listings, &search, INSERT);
+  if (*slot == NULL)
+    {
+      listing = XCNEW (struct auto_load_dir_listing);
+      listing->dirname = search.dirname;
+      *slot = listing;
+      auto_load_read_dir_listing (listing);
+    }
+  else
+    {
+      listing = *slot;
+      xfree (search.dirname);
+    }
+
+  return (listing->names == NULL
+	  || htab_find (listing->names, base) != NULL);
+}
+
+/* Open FILENAME for reading if it may exist.  */
+
+static FILE *
+auto_load_fopen (const char *filename)
+{
+  if (!auto_load_file_may_exist (filename))
+    return NULL;
+
+  return gdb_fopen_cloexec (filename, "r");
+}
+
+/* A cached gdb_realpath of an objfile name.  */
+
+struct auto_load_realpath
+{
+  char *name;
+  char *realname;
+};
+
+/* A hash table of auto_load_realpath objects, or NULL.  */
+
+static htab_t auto_load_realpaths;
+
+static hashval_t
+hash_auto_load_realpath (const void *p)
+{
+  const struct auto_load_realpath *entry = p;
+
+  return htab_hash_string (entry->name);
+}
+
+static int
+eq_auto_load_realpath (const void *a, const void *b)
+{
+  const struct auto_load_realpath *ea = a;
+  const struct auto_load_realpath *eb = b;
+
+  return strcmp (ea->name, eb->name) == 0;
+}
+
+static void
+free_auto_load_realpath (void *p)
+{
+  struct auto_load_realpath *entry = p;
+
+  xfree (entry->name);
+  xfree (entry->realname);
+  xfree (entry);
+}
+
+/* Return a newly allocated copy of gdb_realpath of NAME, which is
+   computed only once for every script language.  */
+
+static char *
+auto_load_cached_realpath (const char *name)
+{
+  struct auto_load_realpath search, *entry;
+  void **slot;
+
+  if (auto_load_realpaths == NULL)
+    auto_load_realpaths
+      = htab_create_alloc (16, hash_auto_load_realpath,
+			   eq_auto_load_realpath,
+			   free_auto_load_realpath, xcalloc, xfree);
+
+  search.name = (char *) name;
+  slot = htab_find_slot (auto_load_realpaths, &search, INSERT);
+  if (*slot == NULL)
+    {
+      entry = XNEW (struct auto_load_realpath);
+      entry->name = xstrdup (name);
+      entry->realname = gdb_realpath (name);
+      *slot = entry;
+    }
+  else
+    entry = *slot;
+
+  return xstrdup (entry->realname);
+}
+
+/* See auto-load.h.  */
+
+void
+auto_load_invalidate_caches (void)
+{
+  if (auto_load_dir_listings != NULL)
+    {
+      htab_delete (auto_load_dir_listings);
+      auto_load_dir_listings = NULL;
+    }
+  if (auto_load_realpaths != NULL)
+    {
+      htab_delete (auto_load_realpaths);
+      auto_load_realpaths = NULL;
+    }
+}
+
+/* Drop the cached listings also while the inferior runs in the
+   background.  This is a before_prompt observer.  */
+
+static void
+auto_load_before_prompt (const char *current_prompt)
+{
+  auto_load_invalidate_caches ();
+}
+
 /* Look for the auto-load script in LANGUAGE associated with OBJFILE where
    OBJFILE's gdb_realpath is REALNAME and load it.  Return 1 if we found any
    matching script, return 0 otherwise.  */
@@ -739,7 +971,7 @@ auto_load_objfile_script_1 (struct objfile *objfile, const char *realname,
 
   cleanups = make_cleanup (xfree, filename);
 
-  input = gdb_fopen_cloexec (filename, "r");
+  input = auto_load_fopen (filename);
   debugfile = filename;
   if (debug_auto_load)
     fprintf_unfiltered (gdb_stdlog, _("auto-load: Attempted file \"%s\" %s.\n"),
@@ -771,7 +1003,7 @@ auto_load_objfile_script_1 (struct objfile *objfile, const char *realname,
 	  strcat (debugfile, filename);
 
 	  make_cleanup (xfree, debugfile);
-	  input = gdb_fopen_cloexec (debugfile, "r");
+	  input = auto_load_fopen (debugfile);
 	  if (debug_auto_load)
 	    fprintf_unfiltered (gdb_stdlog, _("auto-load: Attempted file "
 					      "\"%s\" %s.\n"),
@@ -809,7 +1041,7 @@ void
 auto_load_objfile_script (struct objfile *objfile,
 			  const struct script_language *language)
 {
-  char *realname = gdb_realpath (objfile->name);
+  char *realname = auto_load_cached_realpath (objfile->name);
   struct cleanup *cleanups = make_cleanup (xfree, realname);
 
   if (!auto_load_objfile_script_1 (objfile, realname, language))
@@ -1197,6 +1429,7 @@ _initialize_auto_load (void)
 						auto_load_pspace_data_cleanup);
 
   observer_attach_new_objfile (auto_load_new_objfile);
+  observer_attach_before_prompt (auto_load_before_prompt);
 
   add_setshow_boolean_cmd ("gdb-scripts", class_support,
 			   &auto_load_gdb_scripts, _("\
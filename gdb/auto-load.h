@@ -45,6 +45,11 @@ extern int maybe_add_script (struct auto_load_pspace_info *pspace_info,
 extern void auto_load_objfile_script (struct objfile *objfile,
 				      const struct script_language *language);
 extern void load_auto_scripts_for_objfile (struct objfile *objfile);
+
+/* Forget the directory listings and real paths cached while looking
+   for auto-load scripts.  Called before each command.  */
+extern void auto_load_invalidate_caches (void);
+
 extern int
   script_not_found_warning_print (struct auto_load_pspace_info *pspace_info);
 extern char auto_load_info_scripts_pattern_nl[];
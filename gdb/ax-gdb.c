@@ -886,7 +886,7 @@ gen_conversion (struct agent_expr *ax, struct type *from, struct type *to)
   /* If we're converting to a narrower type, then we need to clear out
      the upper bits.  */
   if (TYPE_LENGTH (to) < TYPE_LENGTH (from))
-    gen_extend (ax, from);
+    gen_extend (ax, to);
 
   /* If the two values have equal width, but different signednesses,
      then we need to extend.  */
@@ -2578,6 +2578,303 @@ gen_printf (CORE_ADDR scope, struct gdbarch *gdbarch,
   return ax;
 }
 
+/* Evaluating agent expressions within GDB itself.  Conditions that
+   GDB has to test on every breakpoint hit are much cheaper to run
+   as bytecode than through evaluate_expression, since the bytecode
+   works on plain integers and reads exactly the memory and registers
+   it needs, without building struct values.  */
+
+/* The deepest stack ax_host_eval will run with.  */
+#define AX_HOST_STACK_MAX 64
+
+/* Read the N-byte big-endian operand at offset O of AX.  */
+
+static ULONGEST
+ax_host_operand (struct agent_expr *ax, int o, int n)
+{
+  ULONGEST val = 0;
+  int i;
+
+  for (i = 0; i < n; i++)
+    val = (val << 8) | ax->buf[o + i];
+
+  return val;
+}
+
+/* See ax-gdb.h.  */
+
+int
+ax_host_evaluable_p (struct agent_expr *ax)
+{
+  int i;
+
+  ax_reqs (ax);
+  if (ax->flaw != agent_flaw_none
+      || ax->min_height < 0
+      || ax->max_height > AX_HOST_STACK_MAX)
+    return 0;
+
+  for (i = 0; i < ax->len; i += 1 + aop_map[ax->buf[i]].op_size)
+    switch (ax->buf[i])
+      {
+      case aop_goto:
+      case aop_if_goto:
+	/* GDB only generates forward jumps; refusing anything else
+	   guarantees that evaluation terminates.  */
+	if (ax_host_operand (ax, i + 1, 2) <= i)
+	  return 0;
+	break;
+
+      case aop_reg:
+	if (ax_host_operand (ax, i + 1, 2) >= gdbarch_num_regs (ax->gdbarch))
+	  return 0;
+	break;
+
+      case aop_add: case aop_sub: case aop_mul:
+      case aop_div_signed: case aop_div_unsigned:
+      case aop_rem_signed: case aop_rem_unsigned:
+      case aop_lsh: case aop_rsh_signed: case aop_rsh_unsigned:
+      case aop_log_not: case aop_bit_and: case aop_bit_or:
+      case aop_bit_xor: case aop_bit_not: case aop_equal:
+      case aop_less_signed: case aop_less_unsigned:
+      case aop_ext: case aop_zero_ext:
+      case aop_ref8: case aop_ref16: case aop_ref32: case aop_ref64:
+      case aop_const8: case aop_const16: case aop_const32: case aop_const64:
+      case aop_end: case aop_dup: case aop_pop: case aop_swap:
+      case aop_pick: case aop_rot:
+	break;
+
+      default:
+	/* Floating point, tracing, trace state variables and printf
+	   have no host-side meaning here.  */
+	return 0;
+      }
+
+  return 1;
+}
+
+/* See ax-gdb.h.  */
+
+int
+ax_host_eval (struct agent_expr *ax, struct regcache *regcache,
+	      LONGEST *result)
+{
+  enum bfd_endian byte_order = gdbarch_byte_order (ax->gdbarch);
+  ULONGEST stack[AX_HOST_STACK_MAX];
+  gdb_byte buf[8];
+  int pc = 0, sp = 0;
+
+  if (get_regcache_arch (regcache) != ax->gdbarch)
+    return 0;
+
+  while (pc < ax->len)
+    {
+      enum agent_op op = ax->buf[pc];
+      ULONGEST a, b;
+      int n;
+
+      switch (op)
+	{
+	case aop_add:
+	  sp--;
+	  stack[sp - 1] += stack[sp];
+	  break;
+
+	case aop_sub:
+	  sp--;
+	  stack[sp - 1] -= stack[sp];
+	  break;
+
+	case aop_mul:
+	  sp--;
+	  stack[sp - 1] *= stack[sp];
+	  break;
+
+	case aop_div_signed:
+	case aop_rem_signed:
+	  a = stack[sp - 2];
+	  b = stack[sp - 1];
+	  sp--;
+	  if (b == 0)
+	    return 0;
+	  /* Dividing the most negative value by -1 traps on some
+	     hosts; negating in unsigned arithmetic gives the wrapped
+	     result without that.  */
+	  if ((LONGEST) b == -1)
+	    stack[sp - 1] = op == aop_div_signed ? -a : 0;
+	  else if (op == aop_div_signed)
+	    stack[sp - 1] = (LONGEST) a / (LONGEST) b;
+	  else
+	    stack[sp - 1] = (LONGEST) a % (LONGEST) b;
+	  break;
+
+	case aop_div_unsigned:
+	case aop_rem_unsigned:
+	  a = stack[sp - 2];
+	  b = stack[sp - 1];
+	  sp--;
+	  if (b == 0)
+	    return 0;
+	  stack[sp - 1] = op == aop_div_unsigned ? a / b : a % b;
+	  break;
+
+	case aop_lsh:
+	case aop_rsh_signed:
+	case aop_rsh_unsigned:
+	  a = stack[sp - 2];
+	  b = stack[sp - 1];
+	  sp--;
+	  if (b >= sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    return 0;
+	  if (op == aop_lsh)
+	    stack[sp - 1] = a << b;
+	  else if (op == aop_rsh_signed)
+	    stack[sp - 1] = (LONGEST) a >> b;
+	  else
+	    stack[sp - 1] = a >> b;
+	  break;
+
+	case aop_log_not:
+	  stack[sp - 1] = !stack[sp - 1];
+	  break;
+
+	case aop_bit_and:
+	  sp--;
+	  stack[sp - 1] &= stack[sp];
+	  break;
+
+	case aop_bit_or:
+	  sp--;
+	  stack[sp - 1] |= stack[sp];
+	  break;
+
+	case aop_bit_xor:
+	  sp--;
+	  stack[sp - 1] ^= stack[sp];
+	  break;
+
+	case aop_bit_not:
+	  stack[sp - 1] = ~stack[sp - 1];
+	  break;
+
+	case aop_equal:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] == stack[sp];
+	  break;
+
+	case aop_less_signed:
+	  sp--;
+	  stack[sp - 1] = (LONGEST) stack[sp - 1] < (LONGEST) stack[sp];
+	  break;
+
+	case aop_less_unsigned:
+	  sp--;
+	  stack[sp - 1] = stack[sp - 1] < stack[sp];
+	  break;
+
+	case aop_ext:
+	  n = ax->buf[pc + 1];
+	  if (n > 0 && n < sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    {
+	      ULONGEST sign = (ULONGEST) 1 << (n - 1);
+
+	      a = stack[sp - 1] & (((ULONGEST) 1 << n) - 1);
+	      stack[sp - 1] = (a ^ sign) - sign;
+	    }
+	  break;
+
+	case aop_zero_ext:
+	  n = ax->buf[pc + 1];
+	  if (n < sizeof (ULONGEST) * HOST_CHAR_BIT)
+	    stack[sp - 1] &= ((ULONGEST) 1 << n) - 1;
+	  break;
+
+	case aop_ref8:
+	case aop_ref16:
+	case aop_ref32:
+	case aop_ref64:
+	  n = aop_map[op].data_size / 8;
+	  if (target_read_memory (stack[sp - 1], buf, n) != 0)
+	    return 0;
+	  stack[sp - 1] = extract_unsigned_integer (buf, n, byte_order);
+	  break;
+
+	case aop_if_goto:
+	  sp--;
+	  if (stack[sp])
+	    {
+	      pc = ax_host_operand (ax, pc + 1, 2);
+	      continue;
+	    }
+	  break;
+
+	case aop_goto:
+	  pc = ax_host_operand (ax, pc + 1, 2);
+	  continue;
+
+	case aop_const8:
+	case aop_const16:
+	case aop_const32:
+	case aop_const64:
+	  stack[sp++] = ax_host_operand (ax, pc + 1, aop_map[op].op_size);
+	  break;
+
+	case aop_reg:
+	  {
+	    int regnum = ax_host_operand (ax, pc + 1, 2);
+
+	    if (regcache_raw_read_unsigned (regcache, regnum, &a) != REG_VALID)
+	      return 0;
+	    stack[sp++] = a;
+	  }
+	  break;
+
+	case aop_end:
+	  if (sp < 1)
+	    return 0;
+	  *result = stack[sp - 1];
+	  return 1;
+
+	case aop_dup:
+	  stack[sp] = stack[sp - 1];
+	  sp++;
+	  break;
+
+	case aop_pop:
+	  sp--;
+	  break;
+
+	case aop_swap:
+	  a = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = a;
+	  break;
+
+	case aop_pick:
+	  n = ax->buf[pc + 1];
+	  if (n >= sp)
+	    return 0;
+	  stack[sp] = stack[sp - 1 - n];
+	  sp++;
+	  break;
+
+	case aop_rot:
+	  a = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = stack[sp - 3];
+	  stack[sp - 3] = a;
+	  break;
+
+	default:
+	  return 0;
+	}
+
+      pc += 1 + aop_map[op].op_size;
+    }
+
+  return 0;
+}
+
 static void
 agent_eval_command_one (const char *exp, int eval, CORE_ADDR pc)
 {
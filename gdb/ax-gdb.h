@@ -21,6 +21,7 @@
 
 struct expression;
 union exp_element;
+struct regcache;
 
 /* Types and enums */
 
@@ -124,4 +125,20 @@ extern struct agent_expr *gen_printf (CORE_ADDR, struct gdbarch *,
 				      struct format_piece *,
 				      int, struct expression **);
 
+/* Return non-zero if AX only uses bytecodes that ax_host_eval
+   implements, and has a bounded stack and forward jumps only.  This
+   runs ax_reqs on AX.  */
+
+extern int ax_host_evaluable_p (struct agent_expr *ax);
+
+/* Evaluate AX, which ax_host_evaluable_p must have accepted, against
+   the registers in REGCACHE and the current inferior's memory.  On
+   success store the value left on the stack in *RESULT and return
+   non-zero.  Return zero if AX could not be evaluated, e.g. because
+   memory was unreadable or a division by zero occurred; the caller
+   should then fall back to evaluating the original expression.  */
+
+extern int ax_host_eval (struct agent_expr *ax, struct regcache *regcache,
+			 LONGEST *result);
+
 #endif /* AX_GDB_H */
@@ -68,6 +68,7 @@
 #include "skip.h"
 #include "gdb_regex.h"
 #include "ax-gdb.h"
+#include "regcache.h"
 #include "dummy-frame.h"
 
 #include "format.h"
@@ -187,6 +188,8 @@ static int breakpoint_1 (char *, int,
 
 static int breakpoint_cond_eval (void *);
 
+static void update_host_cond_bytecode (struct bp_location *loc);
+
 static void cleanup_executing_breakpoints (void *);
 
 static void commands_command (char *, int);
@@ -931,6 +934,7 @@ set_breakpoint_condition (struct breakpoint *b, char *exp,
 	{
 	  xfree (loc->cond);
 	  loc->cond = NULL;
+	  update_host_cond_bytecode (loc);
 
 	  /* No need to free the condition agent expression
 	     bytecode (if we have one).  We will handle this
@@ -975,6 +979,7 @@ set_breakpoint_condition (struct breakpoint *b, char *exp,
 			     block_for_pc (loc->address), 0);
 	      if (*arg)
 		error (_("Junk at end of expression"));
+	      update_host_cond_bytecode (loc);
 	    }
 	}
     }
@@ -2068,6 +2073,30 @@ parse_cond_to_aexpr (CORE_ADDR scope, struct expression *cond)
   return aexpr;
 }
 
+/* Recompile LOC's condition into LOC->host_cond_bytecode, for
+   evaluation by GDB when the location is hit.  Called whenever
+   LOC->cond changes.  Conditions that need anything the host-side
+   bytecode interpreter cannot do are left without bytecode, and are
+   always evaluated as expressions.  */
+
+static void
+update_host_cond_bytecode (struct bp_location *loc)
+{
+  if (loc->host_cond_bytecode)
+    {
+      free_agent_expr (loc->host_cond_bytecode);
+      loc->host_cond_bytecode = NULL;
+    }
+
+  loc->host_cond_bytecode = parse_cond_to_aexpr (loc->address, loc->cond);
+  if (loc->host_cond_bytecode != NULL
+      && !ax_host_evaluable_p (loc->host_cond_bytecode))
+    {
+      free_agent_expr (loc->host_cond_bytecode);
+      loc->host_cond_bytecode = NULL;
+    }
+}
+
 /* Based on location BL, create a list of breakpoint conditions to be
    passed on to the target.  If we have duplicated locations with different
    conditions, we will add such conditions to the list.  The idea is that the
@@ -4594,6 +4623,45 @@ breakpoint_cond_eval (void *exp)
   return i;
 }
 
+/* Try to evaluate BL's condition with its host-side bytecode, in the
+   innermost frame.  On success, set *VALUE_IS_ZERO as
+   breakpoint_cond_eval would and return 1.  Return 0 if the condition
+   has to be evaluated as an expression instead, e.g. because the
+   bytecode reads unreadable memory; that reports any error the
+   proper way.  */
+
+static int
+breakpoint_cond_eval_bytecode (const struct bp_location *bl,
+			       int *value_is_zero)
+{
+  struct frame_info *frame;
+  volatile struct gdb_exception ex;
+  LONGEST result = 0;
+  int ok = 0;
+
+  if (bl->host_cond_bytecode == NULL)
+    return 0;
+
+  /* The bytecode was compiled for the scope at BL's address, and
+     reads registers straight from the regcache.  Only use it when
+     the innermost frame is a normal one stopped right there.  */
+  frame = get_current_frame ();
+  if (get_frame_type (frame) != NORMAL_FRAME
+      || get_frame_pc (frame) != bl->address)
+    return 0;
+
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      ok = ax_host_eval (bl->host_cond_bytecode, get_current_regcache (),
+			 &result);
+    }
+  if (ex.reason < 0 || !ok)
+    return 0;
+
+  *value_is_zero = (result == 0);
+  return 1;
+}
+
 /* Allocate a new bpstat.  Link it to the FIFO list by BS_LINK_POINTER.  */
 
 static bpstat
@@ -5123,10 +5191,14 @@ bpstat_check_breakpoint_conditions (bpstat bs, ptid_t ptid)
 		within_current_scope = 0;
 	    }
 	  if (within_current_scope)
-	    value_is_zero
-	      = catch_errors (breakpoint_cond_eval, cond,
-			      "Error in testing breakpoint condition:\n",
-			      RETURN_MASK_ALL);
+	    {
+	      if (w != NULL
+		  || !breakpoint_cond_eval_bytecode (bl, &value_is_zero))
+		value_is_zero
+		  = catch_errors (breakpoint_cond_eval, cond,
+				  "Error in testing breakpoint condition:\n",
+				  RETURN_MASK_ALL);
+	    }
 	  else
 	    {
 	      warning (_("Watchpoint condition cannot be tested "
@@ -6825,6 +6897,7 @@ init_bp_location (struct bp_location *loc, const struct bp_location_ops *ops,
   loc->owner = owner;
   loc->cond = NULL;
   loc->cond_bytecode = NULL;
+  loc->host_cond_bytecode = NULL;
   loc->shlib_disabled = 0;
   loc->enabled = 1;
 
@@ -9097,6 +9170,7 @@ init_breakpoint_sal (struct breakpoint *b, struct gdbarch *gdbarch,
 				   block_for_pc (loc->address), 0);
 	  if (*arg)
               error (_("Garbage '%s' follows condition"), arg);
+	  update_host_cond_bytecode (loc);
 	}
 
       /* Dynamic printf requires and uses additional arguments on the
@@ -12600,6 +12674,8 @@ bp_location_dtor (struct bp_location *self)
   xfree (self->cond);
   if (self->cond_bytecode)
     free_agent_expr (self->cond_bytecode);
+  if (self->host_cond_bytecode)
+    free_agent_expr (self->host_cond_bytecode);
   xfree (self->function_name);
 }
 
@@ -13968,6 +14044,7 @@ update_breakpoint_locations (struct breakpoint *b,
 	      new_loc->cond = parse_exp_1 (&s, sals.sals[i].pc,
 					   block_for_pc (sals.sals[i].pc), 
 					   0);
+	      update_host_cond_bytecode (new_loc);
 	    }
 	  if (e.reason < 0)
 	    {
@@ -356,6 +356,11 @@ struct bp_location
      condition evaluation.  */
   struct agent_expr *cond_bytecode;
 
+  /* The same condition compiled to bytecode that GDB runs itself when
+     it evaluates the condition, or NULL if COND could not be compiled
+     to bytecode GDB knows how to run.  See update_host_cond_bytecode.  */
+  struct agent_expr *host_cond_bytecode;
+
   /* Signals that the condition has changed since the last time
      we updated the global location list.  This means the condition
      needs to be sent to the target again.  This is used together
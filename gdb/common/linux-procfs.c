@@ -25,6 +25,8 @@
 
 #include "linux-procfs.h"
 #include "filestuff.h"
+#include <dirent.h>
+#include <stdlib.h>
 
 /* Return the TGID of LWPID from /proc/pid/status.  Returns -1 if not
    found.  */
@@ -119,3 +121,35 @@ linux_proc_pid_is_zombie (pid_t pid)
 {
   return linux_proc_pid_has_state (pid, "Z (zombie)");
 }
+
+/* See linux-procfs.h.  */
+
+int
+linux_proc_iterate_tasks (pid_t pid, int (*func) (pid_t lwp, void *data),
+			  void *data)
+{
+  char path[64];
+  DIR *dir;
+  struct dirent *dp;
+  int ret = 0;
+
+  xsnprintf (path, sizeof (path), "/proc/%d/task", (int) pid);
+  dir = opendir (path);
+  if (dir == NULL)
+    return -1;
+
+  while (ret == 0 && (dp = readdir (dir)) != NULL)
+    {
+      char *end;
+      unsigned long lwp = strtoul (dp->d_name, &end, 10);
+
+      /* Skip "." and "..".  */
+      if (end == dp->d_name || *end != '\0' || lwp == 0)
+	continue;
+
+      ret = func ((pid_t) lwp, data);
+    }
+
+  closedir (dir);
+  return ret;
+}
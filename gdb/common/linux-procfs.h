@@ -40,4 +40,12 @@ extern int linux_proc_pid_is_stopped (pid_t pid);
 
 extern int linux_proc_pid_is_zombie (pid_t pid);
 
+/* Call FUNC with each LWP listed in /proc/PID/task, and DATA.  Stop
+   early when FUNC returns non-zero, and return that value.  Return -1
+   if the task directory can not be read, and 0 otherwise.  */
+
+extern int linux_proc_iterate_tasks (pid_t pid,
+				     int (*func) (pid_t lwp, void *data),
+				     void *data);
+
 #endif /* COMMON_LINUX_PROCFS_H */
@@ -252,9 +252,8 @@ struct header_file_location
 				   BINCL/EINCL defs for this file.  */
 };
 
-/* The actual list and controling variables.  */
-static struct header_file_location *bincl_list, *next_bincl;
-static int bincls_allocated;
+/* The bincls seen so far, indexed by name and instance.  */
+static htab_t bincl_hash;
 
 /* Local function prototypes.  */
 
@@ -343,6 +342,39 @@ add_this_object_header_file (int i)
   this_object_header_files[n_this_object_header_files++] = i;
 }
 
+/* An entry in the index of an objfile's header files, which maps the
+   name and instance of a header file to its position in HEADER_FILES.
+   NAME is shared with the header_file entry.  */
+
+struct header_file_index_entry
+{
+  const char *name;
+  int instance;
+  int index;
+};
+
+/* Hash function for the header file index.  */
+
+static hashval_t
+hash_header_file_index_entry (const void *p)
+{
+  const struct header_file_index_entry *e = p;
+
+  return filename_hash (e->name) ^ e->instance;
+}
+
+/* Equality function for the header file index.  */
+
+static int
+eq_header_file_index_entry (const void *a, const void *b)
+{
+  const struct header_file_index_entry *ea = a;
+  const struct header_file_index_entry *eb = b;
+
+  return (ea->instance == eb->instance
+	  && filename_cmp (ea->name, eb->name) == 0);
+}
+
 /* Add to this file an "old" header file, one already seen in
    a previous object file.  NAME is the header file's name.
    INSTANCE is its instance code, to select among multiple
@@ -351,15 +383,18 @@ add_this_object_header_file (int i)
 static void
 add_old_header_file (char *name, int instance)
 {
-  struct header_file *p = HEADER_FILES (dbxread_objfile);
-  int i;
-
-  for (i = 0; i < N_HEADER_FILES (dbxread_objfile); i++)
-    if (filename_cmp (p[i].name, name) == 0 && instance == p[i].instance)
-      {
-	add_this_object_header_file (i);
-	return;
-      }
+  struct dbx_symfile_info *dbx = DBX_SYMFILE_INFO (dbxread_objfile);
+  struct header_file_index_entry key, *entry = NULL;
+
+  key.name = name;
+  key.instance = instance;
+  if (dbx->header_files_index != NULL)
+    entry = htab_find (dbx->header_files_index, &key);
+  if (entry != NULL)
+    {
+      add_this_object_header_file (entry->index);
+      return;
+    }
   repeated_header_complaint (name, symnum);
 }
 
@@ -379,6 +414,8 @@ add_new_header_file (char *name, int instance)
 {
   int i;
   struct header_file *hfile;
+  struct dbx_symfile_info *dbx;
+  struct header_file_index_entry key, **slot;
 
   /* Make sure there is room for one more header file.  */
 
@@ -413,6 +450,25 @@ add_new_header_file (char *name, int instance)
     = (struct type **) xmalloc (10 * sizeof (struct type *));
   memset (hfile->vector, 0, 10 * sizeof (struct type *));
 
+  /* Index the header file for add_old_header_file, which uses the
+     first of several entries with the same name and instance.  */
+  dbx = DBX_SYMFILE_INFO (dbxread_objfile);
+  if (dbx->header_files_index == NULL)
+    dbx->header_files_index
+      = htab_create_alloc (10, hash_header_file_index_entry,
+			   eq_header_file_index_entry, xfree,
+			   xcalloc, xfree);
+  key.name = hfile->name;
+  key.instance = instance;
+  slot = (struct header_file_index_entry **)
+    htab_find_slot (dbx->header_files_index, &key, INSERT);
+  if (*slot == NULL)
+    {
+      *slot = XNEW (struct header_file_index_entry);
+      **slot = key;
+      (*slot)->index = i;
+    }
+
   add_this_object_header_file (i);
 }
 
@@ -752,6 +808,9 @@ dbx_free_symfile_info (struct objfile *objfile, void *arg)
       xfree (hfiles);
     }
 
+  if (dbx->header_files_index != NULL)
+    htab_delete (dbx->header_files_index);
+
   xfree (dbx);
 }
 
@@ -889,15 +948,37 @@ dbx_next_symbol_text (struct objfile *objfile)
   return nlist.n_strx + stringtab_global + file_string_table_offset;
 }
 
-/* Initialize the list of bincls to contain none and have some
-   allocated.  */
+/* Hash function for BINCL_HASH.  */
+
+static hashval_t
+hash_header_file_location (const void *p)
+{
+  const struct header_file_location *bincl = p;
+
+  return htab_hash_string (bincl->name) ^ bincl->instance;
+}
+
+/* Equality function for BINCL_HASH.  */
+
+static int
+eq_header_file_location (const void *a, const void *b)
+{
+  const struct header_file_location *ba = a;
+  const struct header_file_location *bb = b;
+
+  return (ba->instance == bb->instance
+	  && strcmp (ba->name, bb->name) == 0);
+}
+
+/* Initialize the list of bincls to contain none and have room for
+   NUMBER of them.  */
 
 static void
 init_bincl_list (int number, struct objfile *objfile)
 {
-  bincls_allocated = number;
-  next_bincl = bincl_list = (struct header_file_location *)
-    xmalloc (bincls_allocated * sizeof (struct header_file_location));
+  bincl_hash = htab_create_alloc (number, hash_header_file_location,
+				  eq_header_file_location, xfree,
+				  xcalloc, xfree);
 }
 
 /* Add a bincl to the list.  */
@@ -905,19 +986,21 @@ init_bincl_list (int number, struct objfile *objfile)
 static void
 add_bincl_to_list (struct partial_symtab *pst, char *name, int instance)
 {
-  if (next_bincl >= bincl_list + bincls_allocated)
-    {
-      int offset = next_bincl - bincl_list;
+  struct header_file_location bincl, **slot;
 
-      bincls_allocated *= 2;
-      bincl_list = (struct header_file_location *)
-	xrealloc ((char *) bincl_list,
-		  bincls_allocated * sizeof (struct header_file_location));
-      next_bincl = bincl_list + offset;
+  bincl.name = name;
+  bincl.instance = instance;
+  slot = (struct header_file_location **)
+    htab_find_slot (bincl_hash, &bincl, INSERT);
+
+  /* If the same header file was included with the same contents
+     before, N_EXCLs refer to the first psymtab that included it.  */
+  if (*slot == NULL)
+    {
+      *slot = XNEW (struct header_file_location);
+      **slot = bincl;
+      (*slot)->pst = pst;
     }
-  next_bincl->pst = pst;
-  next_bincl->instance = instance;
-  next_bincl++->name = name;
 }
 
 /* Given a name, value pair, find the corresponding
@@ -927,12 +1010,13 @@ add_bincl_to_list (struct partial_symtab *pst, char *name, int instance)
 static struct partial_symtab *
 find_corresponding_bincl_psymtab (char *name, int instance)
 {
-  struct header_file_location *bincl;
+  struct header_file_location key, *bincl;
 
-  for (bincl = bincl_list; bincl < next_bincl; bincl++)
-    if (bincl->instance == instance
-	&& strcmp (name, bincl->name) == 0)
-      return bincl->pst;
+  key.name = name;
+  key.instance = instance;
+  bincl = htab_find (bincl_hash, &key);
+  if (bincl != NULL)
+    return bincl->pst;
 
   repeated_header_complaint (name, symnum);
   return (struct partial_symtab *) 0;
@@ -943,8 +1027,8 @@ find_corresponding_bincl_psymtab (char *name, int instance)
 static void
 free_bincl_list (struct objfile *objfile)
 {
-  xfree (bincl_list);
-  bincls_allocated = 0;
+  htab_delete (bincl_hash);
+  bincl_hash = NULL;
 }
 
 static void
@@ -45,6 +45,7 @@
 #include "regcache.h"
 #include "bcache.h"
 #include "gdb_bfd.h"
+#include "gdb_stat.h"
 
 extern void _initialize_elfread (void);
 
@@ -1212,61 +1213,92 @@ find_separate_debug_file_by_buildid (struct objfile *objfile)
   return NULL;
 }
 
-/* Scan and build partial symbols for a symbol file.
-   We have been initialized by a call to elf_symfile_init, which
-   currently does nothing.
+/* Return the key under which the minimal symbols of OBJFILE are
+   cached, or NULL if they cannot be cached.  The key is made of the
+   build-id and the size, inode and modification time of the file,
+   since strip and prelink keep the build-id but change the symbols.
+   A file relinked in place may keep its size and its mtime in whole
+   seconds, so the mtime is to the nanosecond where known.  The result
+   is xmalloc'd.  */
 
-   SECTION_OFFSETS is a set of offsets to apply to relocate the symbols
-   in each section.  We simplify it down to a single offset for all
-   symbols.  FIXME.
+static char *
+elf_minsym_cache_key (struct objfile *objfile)
+{
+  struct objfile *backlink = objfile->separate_debug_objfile_backlink;
+  const struct elf_build_id *build_id;
+  bfd *id_bfd = objfile->obfd;
+  const char *suffix = "";
+  struct stat st;
+  ULONGEST mtime_nsec;
+  char *key, *p;
+  size_t i;
+
+  /* Reading stabs needs information from the ELF symbols that is not
+     kept with the minimal symbols; see elfstab_offset_sections.  */
+  if (bfd_get_section_by_name (objfile->obfd, ".stab") != NULL)
+    return NULL;
 
-   This function only does the minimum work necessary for letting the
-   user "name" things symbolically; it does not read the entire symtab.
-   Instead, it reads the external and static symbols and puts them in partial
-   symbol tables.  When more extensive information is requested of a
-   file, the corresponding partial symbol table is mutated into a full
-   fledged symbol table by going back and reading the symbols
-   for real.
+  /* Special symbols, such as the ARM mapping symbols, are handed to
+     the gdbarch while reading the symbol table and are not minimal
+     symbols, so they would be missing when reading from the cache.  */
+  if (gdbarch_record_special_symbol_p (get_objfile_arch (objfile)))
+    return NULL;
 
-   We look for sections with specific names, to tell us what debug
-   format to look for:  FIXME!!!
+  /* A separate debug file has the build-id of the file it belongs to,
+     but different symbols.  The symbols embedded in .gnu_debugdata are
+     read from a BFD named after the file containing them, which usually
+     has no build-id of its own; use that of the containing file.
+     Finding them in the cache saves decompressing the symbol tables.  */
+  if (backlink != NULL)
+    {
+      if (filename_cmp (bfd_get_filename (objfile->obfd),
+			backlink->name) == 0)
+	{
+	  id_bfd = backlink->obfd;
+	  suffix = ".gnu_debugdata";
+	}
+      else
+	suffix = ".debug";
+    }
 
-   elfstab_build_psymtabs() handles STABS symbols;
-   mdebug_build_psymtabs() handles ECOFF debugging information.
+  build_id = build_id_bfd_get (id_bfd);
+  if (build_id == NULL || bfd_stat (id_bfd, &st) != 0)
+    return NULL;
 
-   Note that ELF files have a "minimal" symbol table, which looks a lot
-   like a COFF symbol table, but has only the minimal information necessary
-   for linking.  We process this also, and use the information to
-   build gdb's minimal symbol table.  This gives us some minimal debugging
-   capability even for files compiled without -g.  */
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+  mtime_nsec = st.st_mtim.tv_nsec;
+#else
+  mtime_nsec = 0;
+#endif
+
+  /* Four 64-bit numbers in hex, with a dash before each.  */
+  key = xmalloc (2 * build_id->size + 4 * 17 + strlen (suffix) + 1);
+  p = key;
+  for (i = 0; i < build_id->size; i++)
+    p += xsnprintf (p, 3, "%02x", (unsigned) build_id->data[i]);
+  p += xsnprintf (p, 4 * 17 + 1, "-%s-%s-%s-%s",
+		  phex_nz ((ULONGEST) st.st_size, 8),
+		  phex_nz ((ULONGEST) st.st_ino, 8),
+		  phex_nz ((ULONGEST) st.st_mtime, 8),
+		  phex_nz (mtime_nsec, 8));
+  strcpy (p, suffix);
+
+  return key;
+}
+
+/* Record the minimal symbols from the symbol tables of OBJFILE's BFD:
+   the normal and dynamic symbol tables, and the synthetic symbols BFD
+   makes from them.  */
 
 static void
-elf_symfile_read (struct objfile *objfile, int symfile_flags)
+elf_read_minimal_symbols (struct objfile *objfile)
 {
   bfd *synth_abfd, *abfd = objfile->obfd;
-  struct elfinfo ei;
-  struct cleanup *back_to;
+  struct cleanup *back_to = make_cleanup (null_cleanup, NULL);
   long symcount = 0, dynsymcount = 0, synthcount, storage_needed;
+  long dyn_storage_needed;
   asymbol **symbol_table = NULL, **dyn_symbol_table = NULL;
   asymbol *synthsyms;
-  struct dbx_symfile_info *dbx;
-
-  if (symtab_create_debug)
-    {
-      fprintf_unfiltered (gdb_stdlog,
-			  "Reading minimal symbols of objfile %s ...\n",
-			  objfile->name);
-    }
-
-  init_minimal_symbol_collection ();
-  back_to = make_cleanup_discard_minimal_symbols ();
-
-  memset ((char *) &ei, 0, sizeof (ei));
-
-  /* Allocate struct to keep track of the symfile.  */
-  dbx = XCNEW (struct dbx_symfile_info);
-  set_objfile_data (objfile, dbx_objfile_data_key, dbx);
-  make_cleanup (free_elfinfo, (void *) objfile);
 
   /* Process the normal ELF symbol table first.  This may write some
      chain of info into the dbx_symfile_info of the objfile, which can
@@ -1278,6 +1310,15 @@ elf_symfile_read (struct objfile *objfile, int symfile_flags)
 	   bfd_get_filename (objfile->obfd),
 	   bfd_errmsg (bfd_get_error ()));
 
+  /* Most dynamic symbols are also in the normal symbol table, so the
+     larger of the two is a good estimate of the number of distinct
+     names.  Sizing the table of demangled names for them up front
+     avoids rehashing every name each time the table grows.  */
+  dyn_storage_needed = bfd_get_dynamic_symtab_upper_bound (objfile->obfd);
+  reserve_demangled_names (objfile,
+			   max (storage_needed, dyn_storage_needed)
+			   / sizeof (asymbol *));
+
   if (storage_needed > 0)
     {
       symbol_table = (asymbol **) xmalloc (storage_needed);
@@ -1294,7 +1335,7 @@ elf_symfile_read (struct objfile *objfile, int symfile_flags)
 
   /* Add the dynamic symbols.  */
 
-  storage_needed = bfd_get_dynamic_symtab_upper_bound (objfile->obfd);
+  storage_needed = dyn_storage_needed;
 
   if (storage_needed > 0)
     {
@@ -1355,6 +1396,71 @@ elf_symfile_read (struct objfile *objfile, int symfile_flags)
 		       synth_symbol_table, 1);
     }
 
+  do_cleanups (back_to);
+}
+
+/* Scan and build partial symbols for a symbol file.
+   We have been initialized by a call to elf_symfile_init, which
+   currently does nothing.
+
+   SECTION_OFFSETS is a set of offsets to apply to relocate the symbols
+   in each section.  We simplify it down to a single offset for all
+   symbols.  FIXME.
+
+   This function only does the minimum work necessary for letting the
+   user "name" things symbolically; it does not read the entire symtab.
+   Instead, it reads the external and static symbols and puts them in partial
+   symbol tables.  When more extensive information is requested of a
+   file, the corresponding partial symbol table is mutated into a full
+   fledged symbol table by going back and reading the symbols
+   for real.
+
+   We look for sections with specific names, to tell us what debug
+   format to look for:  FIXME!!!
+
+   elfstab_build_psymtabs() handles STABS symbols;
+   mdebug_build_psymtabs() handles ECOFF debugging information.
+
+   Note that ELF files have a "minimal" symbol table, which looks a lot
+   like a COFF symbol table, but has only the minimal information necessary
+   for linking.  We process this also, and use the information to
+   build gdb's minimal symbol table.  This gives us some minimal debugging
+   capability even for files compiled without -g.  */
+
+static void
+elf_symfile_read (struct objfile *objfile, int symfile_flags)
+{
+  bfd *abfd = objfile->obfd;
+  struct elfinfo ei;
+  struct cleanup *back_to;
+  struct dbx_symfile_info *dbx;
+  char *cache_key;
+  int from_cache;
+
+  if (symtab_create_debug)
+    {
+      fprintf_unfiltered (gdb_stdlog,
+			  "Reading minimal symbols of objfile %s ...\n",
+			  objfile->name);
+    }
+
+  init_minimal_symbol_collection ();
+  back_to = make_cleanup_discard_minimal_symbols ();
+
+  memset ((char *) &ei, 0, sizeof (ei));
+
+  /* Allocate struct to keep track of the symfile.  */
+  dbx = XCNEW (struct dbx_symfile_info);
+  set_objfile_data (objfile, dbx_objfile_data_key, dbx);
+  make_cleanup (free_elfinfo, (void *) objfile);
+
+  cache_key = elf_minsym_cache_key (objfile);
+  make_cleanup (xfree, cache_key);
+  from_cache = (cache_key != NULL
+		&& minimal_symbol_cache_read (objfile, cache_key));
+  if (!from_cache)
+    elf_read_minimal_symbols (objfile);
+
   /* Install any minimal symbols that have been collected as the current
      minimal symbols for this objfile.  The debug readers below this point
      should not generate new minimal symbols; if they do it's their
@@ -1362,6 +1468,8 @@ elf_symfile_read (struct objfile *objfile, int symfile_flags)
      which will do this.  */
 
   install_minimal_symbols (objfile);
+  if (cache_key != NULL && !from_cache)
+    minimal_symbol_cache_write (objfile, cache_key);
   do_cleanups (back_to);
 
   /* Now process debugging information, which is contained in
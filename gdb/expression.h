@@ -103,6 +103,8 @@ extern struct type *parse_expression_for_completion (const char *, char **,
 extern struct expression *parse_exp_1 (const char **, CORE_ADDR pc,
 				       const struct block *, int);
 
+extern void clear_expression_cache (void);
+
 /* For use by parsers; set if we want to parse an expression and
    attempt completion.  */
 extern int parse_completion;
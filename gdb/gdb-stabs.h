@@ -66,6 +66,10 @@ struct dbx_symfile_info
     int n_header_files;
     int n_allocated_header_files;
 
+    /* Maps the name and instance of each header file to its index in
+       HEADER_FILES; see add_old_header_file.  */
+    struct htab *header_files_index;
+
     /* Pointers to BFD sections.  These are used to speed up the building of
        minimal symbols.  */
     asection *text_section;
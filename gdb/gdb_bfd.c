@@ -25,6 +25,9 @@
 #include "gdbcmd.h"
 #include "hashtab.h"
 #include "filestuff.h"
+#include "filenames.h"
+#include "observer.h"
+#include <ctype.h>
 #ifdef HAVE_ZLIB_H
 #include <zlib.h>
 #endif
@@ -457,6 +460,310 @@ get_file_crc (bfd *abfd, unsigned long *file_crc_return)
   return 1;
 }
 
+/* What identifies one version of a file for the CRC cache.  A file
+   rebuilt in place may keep its size and its mtime in whole seconds,
+   so the inode and both times to the nanosecond, where known, are
+   compared too.  */
+
+struct file_crc_identity
+{
+  LONGEST size;
+  LONGEST ino;
+  LONGEST mtime;
+  LONGEST mtime_nsec;
+  LONGEST ctime;
+  LONGEST ctime_nsec;
+};
+
+/* The number of fields of struct file_crc_identity.  */
+
+#define FILE_CRC_IDENTITY_FIELDS 6
+
+/* Fill in *ID from ST.  */
+
+static void
+file_crc_identity_from_stat (const struct stat *st,
+			     struct file_crc_identity *id)
+{
+  id->size = st->st_size;
+  id->ino = st->st_ino;
+  id->mtime = st->st_mtime;
+  id->ctime = st->st_ctime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+  id->mtime_nsec = st->st_mtim.tv_nsec;
+  id->ctime_nsec = st->st_ctim.tv_nsec;
+#else
+  id->mtime_nsec = 0;
+  id->ctime_nsec = 0;
+#endif
+}
+
+/* Return non-zero if A and B identify the same version of a file.  */
+
+static int
+file_crc_identity_eq (const struct file_crc_identity *a,
+		      const struct file_crc_identity *b)
+{
+  return (a->size == b->size
+	  && a->ino == b->ino
+	  && a->mtime == b->mtime
+	  && a->mtime_nsec == b->mtime_nsec
+	  && a->ctime == b->ctime
+	  && a->ctime_nsec == b->ctime_nsec);
+}
+
+/* A file CRC remembered independently of any BFD, so that the CRC of
+   a separate debug file is not recomputed each time the file is
+   opened.  There is one entry per file name, for the version of the
+   file last seen.  */
+
+struct file_crc_entry
+{
+  /* The absolute file name.  */
+  char *filename;
+  /* The version of the file the CRC is for.  */
+  struct file_crc_identity id;
+  /* The file's CRC.  */
+  unsigned long crc;
+};
+
+/* A hash table of file_crc_entry objects, keyed by file name.  */
+
+static htab_t file_crc_cache;
+
+/* The file in which the entries of FILE_CRC_CACHE are saved between
+   sessions, or NULL or empty if they are not saved.  */
+
+static char *debug_file_crc_cache;
+
+/* True if DEBUG_FILE_CRC_CACHE has been read into FILE_CRC_CACHE.  */
+
+static int debug_file_crc_cache_loaded;
+
+/* True if FILE_CRC_CACHE has entries not yet written to
+   DEBUG_FILE_CRC_CACHE.  */
+
+static int debug_file_crc_cache_dirty;
+
+/* A hash function for file_crc_entry.  */
+
+static hashval_t
+hash_file_crc_entry (const void *p)
+{
+  const struct file_crc_entry *entry = p;
+
+  return htab_hash_string (entry->filename);
+}
+
+/* An equality function for file_crc_entry.  */
+
+static int
+eq_file_crc_entry (const void *a, const void *b)
+{
+  const struct file_crc_entry *ea = a;
+  const struct file_crc_entry *eb = b;
+
+  return filename_cmp (ea->filename, eb->filename) == 0;
+}
+
+/* A deletion function for file_crc_entry.  */
+
+static void
+free_file_crc_entry (void *p)
+{
+  struct file_crc_entry *entry = p;
+
+  xfree (entry->filename);
+  xfree (entry);
+}
+
+/* Record CRC as the CRC of the version ID of FILENAME in
+   FILE_CRC_CACHE, replacing any entry for an older version.  */
+
+static void
+file_crc_cache_add (const char *filename,
+		    const struct file_crc_identity *id, unsigned long crc)
+{
+  struct file_crc_entry search, *entry;
+  void **slot;
+
+  if (file_crc_cache == NULL)
+    file_crc_cache = htab_create_alloc (1, hash_file_crc_entry,
+					eq_file_crc_entry,
+					free_file_crc_entry,
+					xcalloc, xfree);
+
+  search.filename = (char *) filename;
+  slot = htab_find_slot (file_crc_cache, &search, INSERT);
+  if (*slot != NULL)
+    entry = *slot;
+  else
+    {
+      entry = XNEW (struct file_crc_entry);
+      entry->filename = xstrdup (filename);
+      *slot = entry;
+    }
+  entry->id = *id;
+  entry->crc = crc;
+}
+
+/* Read DEBUG_FILE_CRC_CACHE into FILE_CRC_CACHE, if this has not been
+   done yet.  Each line of the file holds the CRC in hex, then the
+   size, inode, mtime, mtime nanoseconds, ctime and ctime nanoseconds
+   in decimal, then the file name.  Malformed lines are ignored; a
+   later line for the same file overrides an earlier one.  */
+
+static void
+load_debug_file_crc_cache (void)
+{
+  char line[PATH_MAX + 200];
+  FILE *stream;
+
+  if (debug_file_crc_cache_loaded)
+    return;
+  debug_file_crc_cache_loaded = 1;
+
+  if (debug_file_crc_cache == NULL || *debug_file_crc_cache == '\0')
+    return;
+
+  stream = gdb_fopen_cloexec (debug_file_crc_cache, "r");
+  if (stream == NULL)
+    return;
+
+  while (fgets (line, sizeof (line), stream) != NULL)
+    {
+      const char *p = line;
+      char *end;
+      unsigned long crc;
+      LONGEST fields[FILE_CRC_IDENTITY_FIELDS];
+      struct file_crc_identity id;
+      int i;
+
+      end = strchr (line, '\n');
+      if (end == NULL)
+	continue;
+      *end = '\0';
+
+      crc = strtoulst (p, &p, 16);
+      for (i = 0; i < FILE_CRC_IDENTITY_FIELDS; i++)
+	{
+	  if (*p != ' ' || !isdigit (p[1]))
+	    break;
+	  fields[i] = strtoulst (p + 1, &p, 10);
+	}
+      if (i < FILE_CRC_IDENTITY_FIELDS
+	  || *p != ' ' || !IS_ABSOLUTE_PATH (p + 1))
+	continue;
+
+      id.size = fields[0];
+      id.ino = fields[1];
+      id.mtime = fields[2];
+      id.mtime_nsec = fields[3];
+      id.ctime = fields[4];
+      id.ctime_nsec = fields[5];
+      file_crc_cache_add (p + 1, &id, crc);
+    }
+
+  fclose (stream);
+}
+
+/* Write one entry of FILE_CRC_CACHE to the stdio stream in DATA.  A
+   htab_traverse callback.  */
+
+static int
+write_file_crc_entry (void **slot, void *data)
+{
+  const struct file_crc_entry *entry = *slot;
+  FILE *stream = data;
+
+  fprintf (stream, "%08lx %s %s %s %s %s %s %s\n", entry->crc,
+	   plongest (entry->id.size), plongest (entry->id.ino),
+	   plongest (entry->id.mtime), plongest (entry->id.mtime_nsec),
+	   plongest (entry->id.ctime), plongest (entry->id.ctime_nsec),
+	   entry->filename);
+  return 1;
+}
+
+/* Rewrite DEBUG_FILE_CRC_CACHE from FILE_CRC_CACHE, if it is set and
+   new CRCs have been computed since it was last written.  This is
+   done once per command rather than once per CRC, so that loading a
+   program with many separate debug files writes the file only once.
+   The new contents are written to a temporary file which is then
+   renamed into place, so that the file only ever holds one line per
+   debug file and other sessions never see it half written.  Failures
+   are silently ignored; the cache is only an optimization.  */
+
+static void
+save_debug_file_crc_cache (void)
+{
+  char *tmp;
+  FILE *stream;
+  int ok;
+
+  if (!debug_file_crc_cache_dirty
+      || debug_file_crc_cache == NULL || *debug_file_crc_cache == '\0'
+      || file_crc_cache == NULL)
+    return;
+  debug_file_crc_cache_dirty = 0;
+
+  tmp = xstrprintf ("%s.%ld.tmp", debug_file_crc_cache, (long) getpid ());
+  stream = gdb_fopen_cloexec (tmp, "w");
+  if (stream == NULL)
+    {
+      xfree (tmp);
+      return;
+    }
+
+  htab_traverse (file_crc_cache, write_file_crc_entry, stream);
+  ok = !ferror (stream);
+  if (fclose (stream) != 0)
+    ok = 0;
+
+  if (!ok || rename (tmp, debug_file_crc_cache) != 0)
+    unlink (tmp);
+  xfree (tmp);
+}
+
+/* Compute the CRC of ABFD into *FILE_CRC_RETURN like get_file_crc,
+   but look in FILE_CRC_CACHE first, and record a newly computed CRC
+   there.  Only plain files with an absolute name are cached.  */
+
+static int
+get_file_crc_cached (bfd *abfd, unsigned long *file_crc_return)
+{
+  struct gdb_bfd_data *gdata = bfd_usrdata (abfd);
+  const char *filename = bfd_get_filename (abfd);
+  struct file_crc_entry search, *entry;
+  struct file_crc_identity id;
+  struct stat st;
+
+  if (gdata->archive_bfd != NULL
+      || !IS_ABSOLUTE_PATH (filename)
+      || bfd_stat (abfd, &st) != 0)
+    return get_file_crc (abfd, file_crc_return);
+
+  load_debug_file_crc_cache ();
+
+  file_crc_identity_from_stat (&st, &id);
+  search.filename = (char *) filename;
+  if (file_crc_cache != NULL)
+    {
+      entry = htab_find (file_crc_cache, &search);
+      if (entry != NULL && file_crc_identity_eq (&entry->id, &id))
+	{
+	  *file_crc_return = entry->crc;
+	  return 1;
+	}
+    }
+
+  if (!get_file_crc (abfd, file_crc_return))
+    return 0;
+
+  file_crc_cache_add (filename, &id, *file_crc_return);
+  debug_file_crc_cache_dirty = 1;
+  return 1;
+}
+
 /* See gdb_bfd.h.  */
 
 int
@@ -465,7 +772,7 @@ gdb_bfd_crc (struct bfd *abfd, unsigned long *crc_out)
   struct gdb_bfd_data *gdata = bfd_usrdata (abfd);
 
   if (!gdata->crc_computed)
-    gdata->crc_computed = get_file_crc (abfd, &gdata->crc);
+    gdata->crc_computed = get_file_crc_cached (abfd, &gdata->crc);
 
   if (gdata->crc_computed)
     *crc_out = gdata->crc;
@@ -675,6 +982,48 @@ maintenance_info_bfds (char *arg, int from_tty)
   do_cleanups (cleanup);
 }
 
+/* Write out new CRCs before the prompt is shown.  This is a
+   before_prompt observer.  */
+
+static void
+gdb_bfd_before_prompt (const char *current_prompt)
+{
+  save_debug_file_crc_cache ();
+}
+
+/* Write out new CRCs when GDB exits.  This is a final cleanup, for
+   the commands of a batch session, after which no prompt is shown.  */
+
+static void
+save_debug_file_crc_cache_cleanup (void *arg)
+{
+  save_debug_file_crc_cache ();
+}
+
+/* Implement "set debug-file-crc-cache".  */
+
+static void
+set_debug_file_crc_cache (char *args, int from_tty,
+			  struct cmd_list_element *c)
+{
+  /* Entries already read stay valid; just read the new file too.  */
+  debug_file_crc_cache_loaded = 0;
+}
+
+/* Implement "show debug-file-crc-cache".  */
+
+static void
+show_debug_file_crc_cache (struct ui_file *file, int from_tty,
+			   struct cmd_list_element *c, const char *value)
+{
+  if (*value == '\0')
+    fprintf_filtered (file, _("CRCs of separate debug files "
+			      "are not saved.\n"));
+  else
+    fprintf_filtered (file, _("CRCs of separate debug files "
+			      "are saved in \"%s\".\n"), value);
+}
+
 /* -Wmissing-prototypes */
 extern initialize_file_ftype _initialize_gdb_bfd;
 
@@ -687,4 +1036,20 @@ _initialize_gdb_bfd (void)
   add_cmd ("bfds", class_maintenance, maintenance_info_bfds, _("\
 List the BFDs that are currently open."),
 	   &maintenanceinfolist);
+
+  add_setshow_optional_filename_cmd ("debug-file-crc-cache", class_support,
+				     &debug_file_crc_cache, _("\
+Set the file in which CRCs of separate debug files are saved."), _("\
+Show the file in which CRCs of separate debug files are saved."), _("\
+Checking a \".gnu_debuglink\" section requires the CRC of the whole\n\
+candidate debug file.  If this is set to a file name, GDB saves each CRC\n\
+it computes in that file, along with the debug file's size, inode and\n\
+timestamps, and reuses it in later sessions as long as those still match.\n\
+If empty, CRCs are only remembered for the current session."),
+				     set_debug_file_crc_cache,
+				     show_debug_file_crc_cache,
+				     &setlist, &showlist);
+
+  observer_attach_before_prompt (gdb_bfd_before_prompt);
+  make_final_cleanup (save_debug_file_crc_cache_cleanup, NULL);
 }
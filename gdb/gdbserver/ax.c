@@ -790,6 +790,40 @@ compile_bytecodes (struct agent_expr *aexpr)
 
 #endif
 
+/* Where the pieces of one agent printf go.  GDBserver writes them
+   straight to its stdout.  The in-process agent collects them in BUF,
+   and hands the whole output to agent_printf_output at the end, so
+   that it is written in one piece.  */
+
+struct ax_printf_out
+{
+  char buf[512];
+  int len;
+};
+
+static void
+ax_printf_piece (struct ax_printf_out *out, const char *format, ...)
+{
+  va_list ap;
+
+  va_start (ap, format);
+#ifdef IN_PROCESS_AGENT
+  if (out->len < sizeof (out->buf) - 1)
+    {
+      int n = vsnprintf (out->buf + out->len, sizeof (out->buf) - out->len,
+			 format, ap);
+
+      if (n > 0)
+	out->len += n;
+      if (out->len > sizeof (out->buf) - 1)
+	out->len = sizeof (out->buf) - 1;
+    }
+#else
+  vprintf (format, ap);
+#endif
+  va_end (ap);
+}
+
 /* Make printf-type calls using arguments supplied from the host.  We
    need to parse the format string ourselves, and call the formatting
    function with one argument at a time, partly because there is no
@@ -806,6 +840,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
   int i, fp;
   char *current_substring;
   int nargs_wanted;
+  struct ax_printf_out out;
 
   ax_debug ("Printf of \"%s\" with %d args", format, nargs);
 
@@ -819,6 +854,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
   if (nargs != nargs_wanted)
     error (_("Wrong number of arguments for specified format-string"));
 
+  out.len = 0;
   i = 0;
   for (fp = 0; fpieces[fp].string != NULL; fp++)
     {
@@ -851,7 +887,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
 		read_inferior_memory (tem, str, j);
 	      str[j] = 0;
 
-              printf (current_substring, (char *) str);
+              ax_printf_piece (&out, current_substring, (char *) str);
 	    }
 	    break;
 
@@ -860,7 +896,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
 	    {
 	      long long val = args[i];
 
-              printf (current_substring, val);
+              ax_printf_piece (&out, current_substring, val);
 	      break;
 	    }
 #else
@@ -870,7 +906,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
 	  {
 	    int val = args[i];
 
-	    printf (current_substring, val);
+	    ax_printf_piece (&out, current_substring, val);
 	    break;
 	  }
 
@@ -878,7 +914,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
 	  {
 	    long val = args[i];
 
-	    printf (current_substring, val);
+	    ax_printf_piece (&out, current_substring, val);
 	    break;
 	  }
 
@@ -891,7 +927,7 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
 	     have modified GCC to include -Wformat-security by
 	     default, which will warn here if there is no
 	     argument.  */
-	  printf (current_substring, 0);
+	  ax_printf_piece (&out, current_substring, 0);
 	  break;
 
 	default:
@@ -905,7 +941,11 @@ ax_printf (CORE_ADDR fn, CORE_ADDR chan, const char *format,
     }
 
   free_format_pieces (fpieces);
+#ifdef IN_PROCESS_AGENT
+  agent_printf_output (out.buf, out.len);
+#else
   fflush (stdout);
+#endif
 }
 
 /* The agent expression evaluator, as specified by the GDB docs. It
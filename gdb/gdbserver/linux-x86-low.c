@@ -1536,6 +1536,9 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
 
   /* First, do tracepoint data collection.  Save registers.  */
   i = 0;
+  /* Step over the red zone first; the tracepoint may be in a leaf
+     function keeping its locals there.  */
+  i += push_opcode (&buf[i], "48 8d 64 24 80"); /* lea -0x80(%rsp),%rsp */
   /* Need to ensure stack pointer saved first.  */
   buf[i++] = 0x54; /* push %rsp */
   buf[i++] = 0x55; /* push %rbp */
@@ -1554,6 +1557,13 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
   buf[i++] = 0x41; buf[i++] = 0x51; /* push %r9 */
   buf[i++] = 0x41; buf[i++] = 0x50; /* push %r8 */
   buf[i++] = 0x9c; /* pushfq */
+  append_insns (&buildaddr, i, buf);
+
+  /* Make the saved stack pointer the one the program had, from
+     before the red zone was skipped.  The flags are saved already.  */
+  i = 0;
+  i += push_opcode (&buf[i], "48 81 84 24 80 00 00 00 80 00 00 00");
+					/* addq $0x80,0x80(%rsp) */
   buf[i++] = 0x48; /* movl <addr>,%rdi */
   buf[i++] = 0xbf;
   *((unsigned long *)(buf + i)) = (unsigned long) tpaddr;
@@ -1600,12 +1610,17 @@ amd64_install_fast_tracepoint_jump_pad (CORE_ADDR tpoint, CORE_ADDR tpaddr,
   append_insns (&buildaddr, i, buf);
 
   /* The collector function being in the shared library, may be
-     >31-bits away off the jump pad.  */
+     >31-bits away off the jump pad.  The ABI wants the stack 16-byte
+     aligned at the call; keep the unaligned pointer in %rbx, which
+     the collector preserves.  */
   i = 0;
+  i += push_opcode (&buf[i], "48 89 e3");	/* mov %rsp,%rbx */
+  i += push_opcode (&buf[i], "48 83 e4 f0");	/* and $-16,%rsp */
   i += push_opcode (&buf[i], "48 b8");          /* mov $collector,%rax */
   memcpy (buf + i, &collector, 8);
   i += 8;
   i += push_opcode (&buf[i], "ff d0");          /* callq *%rax */
+  i += push_opcode (&buf[i], "48 89 dc");	/* mov %rbx,%rsp */
   append_insns (&buildaddr, i, buf);
 
   /* Clear the spin-lock.  */
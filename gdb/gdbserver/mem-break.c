@@ -152,7 +152,8 @@ any_persistent_commands ()
 	  return 1;
     }
 
-  return 0;
+  /* Commands moved to jump pads count as well.  */
+  return any_persistent_fast_dprintfs ();
 }
 
 static struct raw_breakpoint *
@@ -921,6 +922,42 @@ add_breakpoint_commands (CORE_ADDR addr, char **command, int persist)
   return 0;
 }
 
+/* See mem-break.h.  */
+
+int
+get_gdb_breakpoint_commands (CORE_ADDR where, struct agent_expr **cond,
+			     struct agent_expr ***commands, int *ncommands,
+			     int *persist)
+{
+  struct breakpoint *bp = find_gdb_breakpoint_at (where);
+  struct point_command_list *cl;
+  int n;
+
+  if (bp == NULL || bp->command_list == NULL
+      || (bp->cond_list != NULL && bp->cond_list->next != NULL))
+    return -1;
+
+  *cond = bp->cond_list != NULL ? bp->cond_list->cond : NULL;
+
+  n = 0;
+  for (cl = bp->command_list; cl != NULL; cl = cl->next)
+    n++;
+
+  /* In the order run_breakpoint_commands runs them.  */
+  *commands = xmalloc (n * sizeof (**commands));
+  *ncommands = n;
+  *persist = 0;
+  n = 0;
+  for (cl = bp->command_list; cl != NULL; cl = cl->next)
+    {
+      (*commands)[n++] = cl->cmd;
+      if (cl->persistence)
+	*persist = 1;
+    }
+
+  return 0;
+}
+
 /* Return true if there are no commands to run at this location,
    which likely means we want to report back to GDB.  */
 int
@@ -24,6 +24,7 @@
 /* Breakpoints are opaque.  */
 struct breakpoint;
 struct fast_tracepoint_jump;
+struct agent_expr;
 
 /* Locate a breakpoint placed at address WHERE and return a pointer
    to its structure.  */
@@ -56,6 +57,17 @@ int add_breakpoint_commands (CORE_ADDR addr, char **commands, int persist);
 
 int any_persistent_commands (void);
 
+/* Return in COND the condition (NULL if none) of the GDB breakpoint at
+   WHERE, and in the malloc'ed array COMMANDS, of NCOMMANDS elements,
+   its commands, for running them from a jump pad instead.  PERSIST is
+   set if any of the commands is persistent.  The expressions still
+   belong to the breakpoint.  Return 0 on success, or -1 if there is no
+   such breakpoint, it has no commands, or more than one condition.  */
+
+int get_gdb_breakpoint_commands (CORE_ADDR where, struct agent_expr **cond,
+				 struct agent_expr ***commands,
+				 int *ncommands, int *persist);
+
 /* Evaluation condition (if any) at breakpoint BP.  Return 1 if
    true and 0 otherwise.  */
 
@@ -1275,6 +1275,66 @@ outreg (struct regcache *regcache, int regno, char *buf)
   return buf;
 }
 
+/* Append a "memory:ADDR,XX..." entry to BUF for each block of memory
+   GDB asked to have expedited with QExpediteMemory.  Blocks whose base
+   register is not pointer-sized, or whose memory can not be read, are
+   left out.  Returns a pointer past the added text.  */
+
+static char *
+outmemory (struct regcache *regcache, char *buf)
+{
+  int i;
+
+  for (i = 0; i < expedited_memory_count; i++)
+    {
+      int regno = expedited_memory[i].regno;
+      int len = expedited_memory[i].len;
+      int align = expedited_memory[i].align;
+      unsigned char data[MAX_EXPEDITED_MEMORY_LEN];
+      CORE_ADDR addr, end;
+
+      if (regno >= regcache->tdesc->num_registers || len == 0)
+	continue;
+
+      /* The registers are in host byte order.  */
+      if (register_size (regcache->tdesc, regno) == 8)
+	{
+	  ULONGEST val;
+
+	  collect_register (regcache, regno, &val);
+	  addr = val;
+	}
+      else if (register_size (regcache->tdesc, regno) == 4)
+	{
+	  unsigned int val;
+
+	  collect_register (regcache, regno, &val);
+	  addr = val;
+	}
+      else
+	continue;
+
+      /* Widen the block to whole multiples of the alignment, within
+	 the size limit.  */
+      end = (addr + len + align - 1) & -(CORE_ADDR) align;
+      addr &= -(CORE_ADDR) align;
+      len = end - addr;
+      if (len > MAX_EXPEDITED_MEMORY_LEN)
+	len = MAX_EXPEDITED_MEMORY_LEN;
+
+      if (read_inferior_memory (addr, data, len) != 0)
+	continue;
+
+      sprintf (buf, "memory:%s,", paddress (addr));
+      buf += strlen (buf);
+      convert_int_to_ascii (data, buf, len);
+      buf += 2 * len;
+      *buf++ = ';';
+    }
+
+  return buf;
+}
+
 void
 new_thread_notify (int id)
 {
@@ -1360,6 +1420,7 @@ prepare_resume_reply (char *buf, ptid_t ptid,
 	    buf = outreg (regcache, find_regno (regcache->tdesc, *regp), buf);
 	    regp ++;
 	  }
+	buf = outmemory (regcache, buf);
 	*buf = '\0';
 
 	/* Formerly, if the debugger had not used any thread features
@@ -1703,11 +1764,13 @@ relocate_instruction (CORE_ADDR *to, CORE_ADDR oldloc)
      wait for the qRelocInsn "response".  That requires re-entering
      the main loop.  For now, this is an adequate approximation; allow
      GDB to access memory.  */
-  while (own_buf[0] == 'm' || own_buf[0] == 'M' || own_buf[0] == 'X')
+  while (own_buf[0] == 'm' || own_buf[0] == 'x'
+	 || own_buf[0] == 'M' || own_buf[0] == 'X')
     {
       CORE_ADDR mem_addr;
       unsigned char *mem_buf = NULL;
       unsigned int mem_len;
+      int reply_len = -1;
 
       if (own_buf[0] == 'm')
 	{
@@ -1718,6 +1781,24 @@ relocate_instruction (CORE_ADDR *to, CORE_ADDR oldloc)
 	  else
 	    write_enn (own_buf);
 	}
+      else if (own_buf[0] == 'x')
+	{
+	  decode_m_packet (&own_buf[1], &mem_addr, &mem_len);
+	  mem_buf = xmalloc (mem_len);
+	  if (read_inferior_memory (mem_addr, mem_buf, mem_len) == 0)
+	    {
+	      int out_len;
+
+	      /* Send what fits; GDB asks for the rest.  */
+	      own_buf[0] = 'b';
+	      reply_len = remote_escape_output (mem_buf, mem_len,
+						(unsigned char *) own_buf + 1,
+						&out_len,
+						sizeof (own_buf) - 2) + 1;
+	    }
+	  else
+	    write_enn (own_buf);
+	}
       else if (own_buf[0] == 'X')
 	{
 	  if (decode_X_packet (&own_buf[1], len - 1, &mem_addr,
@@ -1736,7 +1817,9 @@ relocate_instruction (CORE_ADDR *to, CORE_ADDR oldloc)
 	    write_enn (own_buf);
 	}
       free (mem_buf);
-      if (putpkt (own_buf) < 0)
+      if ((reply_len >= 0
+	   ? putpkt_binary (own_buf, reply_len)
+	   : putpkt (own_buf)) < 0)
 	return -1;
       len = getpkt (own_buf);
       if (len < 0)
@@ -73,6 +73,9 @@ int pass_signals[GDB_SIGNAL_LAST];
 int program_signals[GDB_SIGNAL_LAST];
 int program_signals_p;
 
+struct expedited_memory expedited_memory[MAX_EXPEDITED_MEMORY];
+int expedited_memory_count;
+
 jmp_buf toplevel;
 
 /* The PID of the originally created or attached inferior.  Used to
@@ -533,6 +536,64 @@ handle_general_set (char *own_buf)
       return;
     }
 
+  if (strncmp ("QExpediteMemory:", own_buf,
+	       strlen ("QExpediteMemory:")) == 0)
+    {
+      const char *p = own_buf + strlen ("QExpediteMemory:");
+      struct expedited_memory regions[MAX_EXPEDITED_MEMORY];
+      int count = 0;
+
+      while (*p != '\0')
+	{
+	  ULONGEST regno, len, align;
+
+	  if (count == MAX_EXPEDITED_MEMORY)
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+
+	  p = unpack_varlen_hex ((char *) p, &regno);
+	  if (*p++ != ',')
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+	  p = unpack_varlen_hex ((char *) p, &len);
+	  if (*p++ != ',')
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+	  p = unpack_varlen_hex ((char *) p, &align);
+	  if (align == 0 || (align & (align - 1)) != 0
+	      || align > MAX_EXPEDITED_MEMORY_LEN)
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+	  if (*p == ';')
+	    p++;
+	  else if (*p != '\0')
+	    {
+	      write_enn (own_buf);
+	      return;
+	    }
+
+	  if (len > MAX_EXPEDITED_MEMORY_LEN)
+	    len = MAX_EXPEDITED_MEMORY_LEN;
+	  regions[count].regno = regno;
+	  regions[count].len = len;
+	  regions[count].align = align;
+	  count++;
+	}
+
+      memcpy (expedited_memory, regions, count * sizeof (regions[0]));
+      expedited_memory_count = count;
+      strcpy (own_buf, "OK");
+      return;
+    }
+
   if (strcmp (own_buf, "QStartNoAckMode") == 0)
     {
       if (remote_debug)
@@ -759,6 +820,52 @@ gdb_write_memory (CORE_ADDR memaddr, const unsigned char *myaddr, int len)
     }
 }
 
+static int
+first_thread_of (struct inferior_list_entry *entry, void *args)
+{
+  int pid = * (int *) args;
+
+  if (ptid_get_pid (entry->id) == pid)
+    return 1;
+
+  return 0;
+}
+
+/* Called by requests that take long, such as memory searches and
+   CRCs, between chunks of their work on the memory of process PID.
+   In non-stop mode, other threads keep running meanwhile; handle the
+   events they report now, so that GDB gets their stop notifications
+   without waiting for the request to finish.
+
+   Handling an event may mourn PID, or select a thread of another
+   process.  Returns 1 with a thread of PID selected again if the
+   request can read on, or 0 if PID is gone.  */
+
+static int
+handle_target_events_in_request (int pid)
+{
+  struct thread_info *thread;
+
+  if (!non_stop)
+    return 1;
+
+  handle_target_event (0, NULL);
+
+  if (current_inferior != NULL
+      && ptid_get_pid (current_ptid) == pid)
+    return 1;
+
+  if (find_process_pid (pid) == NULL)
+    return 0;
+  thread = (struct thread_info *) find_inferior (&all_threads,
+						 first_thread_of, &pid);
+  if (thread == NULL)
+    return 0;
+
+  current_inferior = thread;
+  return 1;
+}
+
 /* Subroutine of handle_search_memory to simplify it.  */
 
 static int
@@ -768,6 +875,8 @@ handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 			unsigned chunk_size, unsigned search_buf_size,
 			CORE_ADDR *found_addrp)
 {
+  int pid = ptid_get_pid (current_ptid);
+
   /* Prime the search buffer.  */
 
   if (gdb_read_memory (start_addr, search_buf, search_buf_size)
@@ -823,8 +932,16 @@ handle_search_memory_1 (CORE_ADDR start_addr, CORE_ADDR search_space_len,
 			? search_space_len - keep_len
 			: chunk_size);
 
+	  /* Let the stop events that came in meanwhile through before
+	     reading on.  */
+	  if (!handle_target_events_in_request (pid))
+	    {
+	      warning ("Process %d exited, halting search.", pid);
+	      return -1;
+	    }
+
 	  if (gdb_read_memory (read_addr, search_buf + keep_len,
-			       nr_to_read) != search_buf_size)
+			       nr_to_read) != nr_to_read)
 	    {
 	      warning ("Unable to access %ld bytes of target memory "
 		       "at 0x%lx, halting search.",
@@ -1549,6 +1666,8 @@ static unsigned int crc32_table[256] =
 static unsigned long long
 crc32 (CORE_ADDR base, int len, unsigned int crc)
 {
+  int pid = ptid_get_pid (current_ptid);
+
   if (!crc32_table[1])
     {
       /* Initialize the CRC table and the decoding table.  */
@@ -1563,16 +1682,27 @@ crc32 (CORE_ADDR base, int len, unsigned int crc)
 	}
     }
 
-  while (len--)
+  while (len > 0)
     {
-      unsigned char byte = 0;
+      unsigned char buf[4096];
+      int chunk = len < sizeof (buf) ? len : sizeof (buf);
+      int i, res;
 
       /* Return failure if memory read fails.  */
-      if (read_inferior_memory (base, &byte, 1) != 0)
+      if (prepare_to_access_memory () != 0)
 	return (unsigned long long) -1;
+      res = read_inferior_memory (base, buf, chunk);
+      done_accessing_memory ();
+      if (res != 0)
+	return (unsigned long long) -1;
+
+      for (i = 0; i < chunk; i++)
+	crc = (crc << 8) ^ crc32_table[((crc >> 24) ^ buf[i]) & 255];
+      base += chunk;
+      len -= chunk;
 
-      crc = (crc << 8) ^ crc32_table[((crc >> 24) ^ byte) & 255];
-      base++;
+      if (len > 0 && !handle_target_events_in_request (pid))
+	return (unsigned long long) -1;
     }
   return (unsigned long long) crc;
 }
@@ -1736,7 +1866,8 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
 	}
 
       sprintf (own_buf,
-	       "PacketSize=%x;QPassSignals+;QProgramSignals+",
+	       "PacketSize=%x;QPassSignals+;QProgramSignals+;binary-upload+"
+	       ";QExpediteMemory+",
 	       PBUFSIZ - 1);
 
       if (the_target->qxfer_libraries_svr4 != NULL)
@@ -1805,6 +1936,11 @@ handle_query (char *own_buf, int packet_len, int *new_packet_len_p)
       strcat (own_buf, ";ConditionalBreakpoints+");
       strcat (own_buf, ";BreakpointCommands+");
 
+      /* Commands can be run from a jump pad if fast tracepoints are
+	 supported.  */
+      if (gdb_supports_qRelocInsn && target_supports_fast_tracepoints ())
+	strcat (own_buf, ";FastBreakpointCommands+");
+
       if (target_supports_agent ())
 	strcat (own_buf, ";QAgent+");
 
@@ -2619,17 +2755,6 @@ gdbserver_show_disableable (FILE *stream)
       break;					\
     }
 
-static int
-first_thread_of (struct inferior_list_entry *entry, void *args)
-{
-  int pid = * (int *) args;
-
-  if (ptid_get_pid (entry->id) == pid)
-    return 1;
-
-  return 0;
-}
-
 static void
 kill_inferior_callback (struct inferior_list_entry *entry)
 {
@@ -3027,10 +3152,13 @@ main (int argc, char *argv[])
 
 /* Process options coming from Z packets for *point at address
    POINT_ADDR.  PACKET is the packet buffer.  *PACKET is updated
-   to point to the first char after the last processed option.  */
+   to point to the first char after the last processed option.
+   *FAST_LEN is set to the length of the instruction at POINT_ADDR if
+   GDB would like the commands run from a jump pad, or left alone
+   otherwise.  */
 
 static void
-process_point_options (CORE_ADDR point_addr, char **packet)
+process_point_options (CORE_ADDR point_addr, char **packet, int *fast_len)
 {
   char *dataptr = *packet;
   int persist;
@@ -3062,6 +3190,11 @@ process_point_options (CORE_ADDR point_addr, char **packet)
 	  dataptr += 2;
 	  add_breakpoint_commands (point_addr, &dataptr, persist);
 	}
+      else if (strncmp (dataptr, "fast:", strlen ("fast:")) == 0)
+	{
+	  dataptr += strlen ("fast:");
+	  *fast_len = strtol (dataptr, &dataptr, 16);
+	}
       else
 	{
 	  fprintf (stderr, "Unknown token %c, ignoring.\n",
@@ -3334,6 +3467,26 @@ process_serial_event (void)
       else
 	convert_int_to_ascii (mem_buf, own_buf, res);
       break;
+    case 'x':
+      require_running (own_buf);
+      decode_m_packet (&own_buf[1], &mem_addr, &len);
+      /* No more than the reply can carry, even without escapes.  */
+      if (len > PBUFSIZ - 2)
+	len = PBUFSIZ - 2;
+      res = gdb_read_memory (mem_addr, mem_buf, len);
+      if (res < 0)
+	write_enn (own_buf);
+      else
+	{
+	  int out_len;
+
+	  own_buf[0] = 'b';
+	  new_packet_len
+	    = remote_escape_output (mem_buf, res,
+				    (unsigned char *) own_buf + 1,
+				    &out_len, PBUFSIZ - 2) + 1;
+	}
+      break;
     case 'M':
       require_running (own_buf);
       decode_M_packet (&own_buf[1], &mem_addr, &len, &mem_buf);
@@ -3416,13 +3569,30 @@ process_serial_event (void)
 		   that list and use this one instead.  */
 		if (!res && (type == '0' || type == '1'))
 		  {
+		    int fast_len = 0;
+
 		    /* Remove previous conditions.  */
 		    clear_gdb_breakpoint_conditions (addr);
-		    process_point_options (addr, &dataptr);
+		    process_point_options (addr, &dataptr, &fast_len);
+
+		    /* Likewise, a jump pad running previous commands
+		       goes away, and maybe a new one replaces the
+		       trap.  */
+		    if (type == '0')
+		      {
+			remove_fast_dprintf (addr);
+			if (fast_len > 0)
+			  install_fast_dprintf (addr, fast_len);
+		      }
 		  }
 	      }
 	    else if (!insert && the_target->remove_point != NULL)
-	      res = (*the_target->remove_point) (type, addr, len);
+	      {
+		if (type == '0' && remove_fast_dprintf (addr))
+		  res = 0;
+		else
+		  res = (*the_target->remove_point) (type, addr, len);
+	      }
 	    break;
 	  default:
 	    break;
@@ -233,6 +233,25 @@ extern int pass_signals[];
 extern int program_signals[];
 extern int program_signals_p;
 
+/* A block of memory to send along with each stop reply, set up by the
+   QExpediteMemory packet: LEN bytes starting at the address held in
+   register REGNO, widened out to a multiple of ALIGN.  */
+
+struct expedited_memory
+{
+  int regno;
+  int len;
+  int align;
+};
+
+/* Limits on the QExpediteMemory request, so a stop reply always fits
+   in the packet buffer.  */
+#define MAX_EXPEDITED_MEMORY 4
+#define MAX_EXPEDITED_MEMORY_LEN 512
+
+extern struct expedited_memory expedited_memory[];
+extern int expedited_memory_count;
+
 extern jmp_buf toplevel;
 
 extern int disable_packet_vCont;
@@ -441,12 +460,18 @@ void set_trampoline_buffer_space (CORE_ADDR begin, CORE_ADDR end,
 
 extern const struct target_desc *ipa_tdesc;
 
+void agent_printf_output (const char *text, int len);
+
 #else
 void stop_tracing (void);
 
 int claim_trampoline_space (ULONGEST used, CORE_ADDR *trampoline);
 int have_fast_tracepoint_trampoline_buffer (char *msgbuf);
 void gdb_agent_about_to_close (int pid);
+
+int install_fast_dprintf (CORE_ADDR address, int orig_size);
+int remove_fast_dprintf (CORE_ADDR address);
+int any_persistent_fast_dprintfs (void);
 #endif
 
 struct traceframe;
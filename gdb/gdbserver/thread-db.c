@@ -93,6 +93,13 @@ struct thread_db
 
 static char *libthread_db_search_path;
 
+/* Set by the "set libthread-db-lazy-threads" monitor command.  When
+   set, and the kernel reports clone events, the thread library's
+   thread list is not walked; thread handles are looked up when they
+   are needed.  */
+
+static int libthread_db_lazy_threads;
+
 static int find_one_thread (ptid_t);
 static int find_new_threads_callback (const td_thrhandle_t *th_p, void *data);
 
@@ -416,6 +423,14 @@ thread_db_find_new_threads (void)
   if (find_one_thread (ptid) == 0)
     return;
 
+  /* If we get clone events, we already know every LWP: linux_attach
+     lists /proc/PID/task, and the kernel reports each new clone.  Walking
+     the thread library's list would only fill in thread handles, many
+     memory reads per thread; find_one_thread looks them up when they
+     are needed instead.  */
+  if (libthread_db_lazy_threads && !thread_db_use_events)
+    return;
+
   /* Require 4 successive iterations which do not find any new threads.
      The 4 is a heuristic: there is an inherent race here, and I have
      seen that 2 iterations in a row are not always sufficient to
@@ -939,8 +954,9 @@ thread_db_mourn (struct process_info *proc)
     }
 }
 
-/* Handle "set libthread-db-search-path" monitor command and return 1.
-   For any other command, return 0.  */
+/* Handle "set libthread-db-search-path" and "set
+   libthread-db-lazy-threads" monitor commands and return 1.  For any
+   other command, return 0.  */
 
 int
 thread_db_handle_monitor_command (char *mon)
@@ -948,6 +964,19 @@ thread_db_handle_monitor_command (char *mon)
   const char *cmd = "set libthread-db-search-path";
   size_t cmd_len = strlen (cmd);
 
+  if (strcmp (mon, "set libthread-db-lazy-threads on") == 0)
+    {
+      libthread_db_lazy_threads = 1;
+      monitor_output ("Lazy lookup of libthread_db threads enabled\n");
+      return 1;
+    }
+  else if (strcmp (mon, "set libthread-db-lazy-threads off") == 0)
+    {
+      libthread_db_lazy_threads = 0;
+      monitor_output ("Lazy lookup of libthread_db threads disabled\n");
+      return 1;
+    }
+
   if (strncmp (mon, cmd, cmd_len) == 0
       && (mon[cmd_len] == '\0'
 	  || mon[cmd_len] == ' '))
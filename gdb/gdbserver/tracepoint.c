@@ -124,6 +124,12 @@ trace_vdebug (const char *fmt, ...)
 # define gdb_collect gdb_agent_gdb_collect
 # define stop_tracing gdb_agent_stop_tracing
 # define flush_trace_buffer gdb_agent_flush_trace_buffer
+# define gdb_dprintf_collect gdb_agent_gdb_dprintf_collect
+# define flush_dprintf_buffer gdb_agent_flush_dprintf_buffer
+# define dprintf_buffer gdb_agent_dprintf_buffer
+# define dprintf_buffer_head gdb_agent_dprintf_buffer_head
+# define dprintf_buffer_tail gdb_agent_dprintf_buffer_tail
+# define dprintf_buffer_dropped gdb_agent_dprintf_buffer_dropped
 # define about_to_request_buffer_space gdb_agent_about_to_request_buffer_space
 # define trace_buffer_is_full gdb_agent_trace_buffer_is_full
 # define stopping_tracepoint gdb_agent_stopping_tracepoint
@@ -165,6 +171,12 @@ struct ipa_sym_addresses
   CORE_ADDR addr_gdb_collect;
   CORE_ADDR addr_stop_tracing;
   CORE_ADDR addr_flush_trace_buffer;
+  CORE_ADDR addr_gdb_dprintf_collect;
+  CORE_ADDR addr_flush_dprintf_buffer;
+  CORE_ADDR addr_dprintf_buffer;
+  CORE_ADDR addr_dprintf_buffer_head;
+  CORE_ADDR addr_dprintf_buffer_tail;
+  CORE_ADDR addr_dprintf_buffer_dropped;
   CORE_ADDR addr_about_to_request_buffer_space;
   CORE_ADDR addr_trace_buffer_is_full;
   CORE_ADDR addr_stopping_tracepoint;
@@ -202,6 +214,12 @@ static struct
   IPA_SYM(gdb_collect),
   IPA_SYM(stop_tracing),
   IPA_SYM(flush_trace_buffer),
+  IPA_SYM(gdb_dprintf_collect),
+  IPA_SYM(flush_dprintf_buffer),
+  IPA_SYM(dprintf_buffer),
+  IPA_SYM(dprintf_buffer_head),
+  IPA_SYM(dprintf_buffer_tail),
+  IPA_SYM(dprintf_buffer_dropped),
   IPA_SYM(about_to_request_buffer_space),
   IPA_SYM(trace_buffer_is_full),
   IPA_SYM(stopping_tracepoint),
@@ -358,7 +376,17 @@ tracepoint_look_up_symbols (void)
    "flush_trace_buffer", which triggers an internal breakpoint.
    GDBserver reacts to this breakpoint by pulling the meanwhile
    collected data.  Old frames discarding is always handled on the
-   GDBserver side.  */
+   GDBserver side.
+
+   Likewise, the output of dprintfs run from jump pads (see
+   install_fast_dprintf) is appended to the IPA's "dprintf_buffer"
+   ring, and the IPA calls "flush_dprintf_buffer" when the ring is
+   half full, or when it has not been drained for a while.  GDBserver
+   reacts to that breakpoint by copying the pending output out.  */
+
+/* The size of the in-process dprintf output ring.  Must be a power of
+   two.  */
+#define DPRINTF_BUFFER_SIZE 0x10000
 
 #ifdef IN_PROCESS_AGENT
 int
@@ -393,6 +421,13 @@ flush_trace_buffer (void)
   UNKNOWN_SIDE_EFFECTS();
 }
 
+IP_AGENT_EXPORT void ATTR_USED ATTR_NOINLINE
+flush_dprintf_buffer (void)
+{
+  /* GDBserver places breakpoint here.  */
+  UNKNOWN_SIDE_EFFECTS();
+}
+
 #endif
 
 #ifndef IN_PROCESS_AGENT
@@ -412,6 +447,8 @@ static int stop_tracing_handler (CORE_ADDR);
 struct breakpoint *flush_trace_buffer_bkpt;
 static int flush_trace_buffer_handler (CORE_ADDR);
 
+static int flush_dprintf_buffer_handler (CORE_ADDR);
+
 static void download_trace_state_variables (void);
 static void upload_fast_traceframes (void);
 
@@ -886,7 +923,7 @@ static const char *eval_result_names[] =
 
 /* The tracepoint in which the error occurred.  */
 
-static struct tracepoint *error_tracepoint;
+IP_AGENT_EXPORT struct tracepoint *error_tracepoint;
 
 struct trace_state_variable
 {
@@ -3056,20 +3093,20 @@ clone_fast_tracepoint (struct tracepoint *to, const struct tracepoint *from)
 
 #define MAX_JUMP_SIZE 20
 
-/* Install fast tracepoint.  Return 0 if successful, otherwise return
-   non-zero.  */
+/* Install fast tracepoint TPOINT, whose jump pad calls COLLECTOR.
+   The jump to the jump pad is returned in FJUMP, which must have room
+   for MAX_JUMP_SIZE bytes, and its length in *FJUMP_SIZE.  Return 0 if
+   successful, otherwise return non-zero.  */
 
 static int
-install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
+install_fast_tracepoint_1 (struct tracepoint *tpoint, CORE_ADDR collector,
+			   unsigned char *fjump, ULONGEST *fjump_size,
+			   char *errbuf)
 {
   CORE_ADDR jentry, jump_entry;
   CORE_ADDR trampoline;
   ULONGEST trampoline_size;
   int err = 0;
-  /* The jump to the jump pad of the last fast tracepoint
-     installed.  */
-  unsigned char fjump[MAX_JUMP_SIZE];
-  ULONGEST fjump_size;
 
   if (tpoint->orig_size < target_get_min_fast_tracepoint_insn_len ())
     {
@@ -3086,12 +3123,12 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
   /* Install the jump pad.  */
   err = install_fast_tracepoint_jump_pad (tpoint->obj_addr_on_target,
 					  tpoint->address,
-					  ipa_sym_addrs.addr_gdb_collect,
+					  collector,
 					  ipa_sym_addrs.addr_collecting,
 					  tpoint->orig_size,
 					  &jentry,
 					  &trampoline, &trampoline_size,
-					  fjump, &fjump_size,
+					  fjump, fjump_size,
 					  &tpoint->adjusted_insn_addr,
 					  &tpoint->adjusted_insn_addr_end,
 					  errbuf);
@@ -3101,7 +3138,7 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
 
   /* Wire it in.  */
   tpoint->handle = set_fast_tracepoint_jump (tpoint->address, fjump,
-					     fjump_size);
+					     *fjump_size);
 
   if (tpoint->handle != NULL)
     {
@@ -3118,6 +3155,21 @@ install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
   return 0;
 }
 
+/* Install fast tracepoint.  Return 0 if successful, otherwise return
+   non-zero.  */
+
+static int
+install_fast_tracepoint (struct tracepoint *tpoint, char *errbuf)
+{
+  /* The jump to the jump pad of the last fast tracepoint
+     installed.  */
+  unsigned char fjump[MAX_JUMP_SIZE];
+  ULONGEST fjump_size;
+
+  return install_fast_tracepoint_1 (tpoint, ipa_sym_addrs.addr_gdb_collect,
+				    fjump, &fjump_size, errbuf);
+}
+
 
 /* Install tracepoint TPOINT, and write reply message in OWN_BUF.  */
 
@@ -3492,6 +3544,443 @@ flush_trace_buffer_handler (CORE_ADDR addr)
   return 0;
 }
 
+/* Dprintfs run from jump pads.
+
+   When GDB asks for a breakpoint whose only business is running
+   target-side commands (an agent-style dprintf), and tells us how
+   long the instruction at the breakpoint address is, we install a
+   fast tracepoint jump pad there instead of the trap.  The pad calls
+   the IPA's gdb_dprintf_collect, which tests the condition and runs
+   the commands without stopping the inferior, and appends their
+   output to the IPA's dprintf_buffer.  These are not part of any
+   tracing run, and are kept apart from the tracepoints list.
+
+   Neither jump pad space nor the IPA's heap is ever given back, and
+   GDB removes and inserts breakpoints again at every stop in all-stop
+   mode.  So removing a fast dprintf only puts the original
+   instructions back, and keeps its record; inserting it again with
+   the same condition and commands writes the jump to the same jump
+   pad again.  */
+
+struct fast_dprintf
+{
+  struct fast_dprintf *next;
+
+  /* The process the jump pad was installed in.  */
+  int pid;
+
+  /* True if the commands should keep running while GDB is
+     disconnected.  */
+  int persist;
+
+  /* Breakpoint at "flush_dprintf_buffer", shared by all the fast
+     dprintfs of PID.  */
+  struct breakpoint *flush_bkpt;
+
+  /* The condition and commands the jump pad runs, in the form
+     returned by fast_dprintf_signature.  */
+  char *signature;
+
+  /* The jump to the jump pad.  */
+  unsigned char jump_insn[MAX_JUMP_SIZE];
+  ULONGEST jump_insn_size;
+
+  /* The fast tracepoint whose jump pad runs the commands.  Only the
+     jump pad fields, OBJ_ADDR_ON_TARGET and HANDLE remain meaningful
+     once installed; the condition and commands live in the IPA.
+     HANDLE is NULL while GDB has the breakpoint removed.  */
+  struct tracepoint tpoint;
+};
+
+static struct fast_dprintf *fast_dprintfs;
+
+/* Forget the fast dprintfs of processes that are gone.  Their jump
+   pads and breakpoints went away with the process.  */
+
+static void
+forget_exited_fast_dprintfs (void)
+{
+  struct fast_dprintf *dp, **dp_link;
+
+  dp_link = &fast_dprintfs;
+  while ((dp = *dp_link) != NULL)
+    {
+      if (find_process_pid (dp->pid) == NULL)
+	{
+	  *dp_link = dp->next;
+	  free (dp->signature);
+	  free (dp);
+	}
+      else
+	dp_link = &dp->next;
+    }
+}
+
+/* Return the fast dprintf of the current process at ADDRESS, or
+   NULL.  It may be removed.  */
+
+static struct fast_dprintf *
+find_fast_dprintf (CORE_ADDR address)
+{
+  int pid = ptid_get_pid (current_process ()->head.id);
+  struct fast_dprintf *dp;
+
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->pid == pid && dp->tpoint.address == address)
+      return dp;
+
+  return NULL;
+}
+
+/* Return the drain breakpoint of PID's fast dprintfs, or NULL if PID
+   has none.  */
+
+static struct breakpoint *
+fast_dprintf_flush_bkpt (int pid)
+{
+  struct fast_dprintf *dp;
+
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->pid == pid)
+      return dp->flush_bkpt;
+
+  return NULL;
+}
+
+/* Copy the output the IPA's fast dprintfs have accumulated so far to
+   our stdout, where the output of the commands of ordinary
+   breakpoints goes too.  */
+
+static void
+drain_dprintf_buffer (void)
+{
+  unsigned int head, tail, dropped;
+  unsigned char buf[1024];
+
+  if (read_inferior_uinteger (ipa_sym_addrs.addr_dprintf_buffer_head, &head)
+      || read_inferior_uinteger (ipa_sym_addrs.addr_dprintf_buffer_tail,
+				 &tail))
+    {
+      trace_debug ("Failed to read the dprintf buffer pointers");
+      return;
+    }
+
+  while (tail != head)
+    {
+      unsigned int offset = tail & (DPRINTF_BUFFER_SIZE - 1);
+      unsigned int chunk = head - tail;
+
+      if (chunk > DPRINTF_BUFFER_SIZE - offset)
+	chunk = DPRINTF_BUFFER_SIZE - offset;
+      if (chunk > sizeof (buf))
+	chunk = sizeof (buf);
+
+      if (read_inferior_memory (ipa_sym_addrs.addr_dprintf_buffer + offset,
+				buf, chunk) != 0)
+	break;
+      fwrite (buf, 1, chunk, stdout);
+      tail += chunk;
+    }
+  fflush (stdout);
+
+  write_inferior_uinteger (ipa_sym_addrs.addr_dprintf_buffer_tail, tail);
+
+  if (read_inferior_uinteger (ipa_sym_addrs.addr_dprintf_buffer_dropped,
+			      &dropped) == 0
+      && dropped != 0)
+    {
+      warning ("%u dprintf outputs were dropped", dropped);
+      write_inferior_uinteger (ipa_sym_addrs.addr_dprintf_buffer_dropped, 0);
+    }
+}
+
+static int
+flush_dprintf_buffer_handler (CORE_ADDR addr)
+{
+  trace_debug ("lib hit flush_dprintf_buffer");
+  drain_dprintf_buffer ();
+  return 0;
+}
+
+/* Return the condition COND and the NCOMMANDS commands COMMANDS of a
+   breakpoint in printable form, to tell whether a breakpoint inserted
+   again runs the same ones.  The result is malloc'ed.  */
+
+static char *
+fast_dprintf_signature (struct agent_expr *cond,
+			struct agent_expr **commands, int ncommands)
+{
+  struct buffer buffer;
+  char *hex;
+  int i;
+
+  buffer_init (&buffer);
+  if (cond != NULL)
+    {
+      hex = gdb_unparse_agent_expr (cond);
+      buffer_grow_str (&buffer, hex);
+      free (hex);
+    }
+  for (i = 0; i < ncommands; i++)
+    {
+      hex = gdb_unparse_agent_expr (commands[i]);
+      buffer_grow_str (&buffer, ",");
+      buffer_grow_str (&buffer, hex);
+      free (hex);
+    }
+  buffer_grow_str0 (&buffer, "");
+
+  return buffer_finish (&buffer);
+}
+
+/* Take the jump to the jump pad of the fast dprintf DP out of the
+   code, leaving the jump pad for DP to be inserted again.  The caller
+   has paused all threads, and moved them out of the jump pads.  */
+
+static void
+uninstall_fast_dprintf (struct fast_dprintf *dp)
+{
+  /* Threads still in the jump pad would run the commands again; make
+     the IPA skip it.  */
+  write_inferior_memory (dp->tpoint.obj_addr_on_target
+			 + offsetof (struct tracepoint, enabled),
+			 (unsigned char *) "\0", 1);
+  delete_fast_tracepoint_jump (dp->tpoint.handle);
+  dp->tpoint.handle = NULL;
+  drain_dprintf_buffer ();
+}
+
+/* Forget the removed fast dprintf DP, and free it.  Its jump pad is
+   lost.  */
+
+static void
+delete_fast_dprintf (struct fast_dprintf *dp)
+{
+  struct fast_dprintf **dp_link;
+
+  gdb_assert (dp->tpoint.handle == NULL);
+
+  dp_link = &fast_dprintfs;
+  while (*dp_link != dp)
+    dp_link = &(*dp_link)->next;
+  *dp_link = dp->next;
+
+  if (fast_dprintf_flush_bkpt (dp->pid) == NULL)
+    delete_breakpoint (dp->flush_bkpt);
+
+  free (dp->signature);
+  free (dp);
+}
+
+/* Write the jump to the existing jump pad of the removed fast dprintf
+   DP again.  Return 1 if successful, 0 otherwise.  */
+
+static int
+reinstall_fast_dprintf (struct fast_dprintf *dp)
+{
+  pause_all (0);
+  stabilize_threads ();
+  pause_all (1);
+
+  write_inferior_memory (dp->tpoint.obj_addr_on_target
+			 + offsetof (struct tracepoint, enabled),
+			 (unsigned char *) "\1", 1);
+  dp->tpoint.handle = set_fast_tracepoint_jump (dp->tpoint.address,
+						dp->jump_insn,
+						dp->jump_insn_size);
+  if (dp->tpoint.handle == NULL)
+    {
+      trace_debug ("Failed to reinstall fast dprintf at 0x%s",
+		   paddress (dp->tpoint.address));
+      unpause_all (1);
+      return 0;
+    }
+
+  /* The jump pad takes over from the trap.  */
+  delete_gdb_breakpoint_at (dp->tpoint.address);
+
+  unpause_all (1);
+
+  trace_debug ("Reinstalled fast dprintf at 0x%s",
+	       paddress (dp->tpoint.address));
+  return 1;
+}
+
+/* Replace the GDB breakpoint at ADDRESS by a jump pad that runs its
+   condition and commands in the IPA, if the IPA is loaded and the
+   breakpoint is a candidate.  ORIG_SIZE is the length of the
+   instruction at ADDRESS, as reported by GDB.  Return 1 if the jump
+   pad was installed, 0 if the breakpoint was left as it was.  */
+
+int
+install_fast_dprintf (CORE_ADDR address, int orig_size)
+{
+  struct fast_dprintf *dp;
+  struct tracepoint *tpoint;
+  struct agent_expr *cond;
+  struct agent_expr **commands;
+  int ncommands, persist, i;
+  char *signature;
+  char errbuf[PBUFSIZ];
+
+  if (!agent_loaded_p ()
+      || !target_supports_fast_tracepoints ()
+      || orig_size < target_get_min_fast_tracepoint_insn_len ()
+      || get_gdb_breakpoint_commands (address, &cond, &commands,
+				      &ncommands, &persist) != 0)
+    return 0;
+
+  forget_exited_fast_dprintfs ();
+
+  signature = fast_dprintf_signature (cond, commands, ncommands);
+
+  /* Reuse the jump pad of the fast dprintf this breakpoint had before
+     GDB removed it, if it runs the same commands.  Otherwise the old
+     jump pad is of no further use.  */
+  dp = find_fast_dprintf (address);
+  if (dp != NULL && dp->tpoint.handle == NULL)
+    {
+      if (dp->tpoint.orig_size == orig_size
+	  && strcmp (dp->signature, signature) == 0)
+	{
+	  free (signature);
+	  free (commands);
+	  dp->persist = persist;
+	  return reinstall_fast_dprintf (dp);
+	}
+
+      delete_fast_dprintf (dp);
+    }
+
+  if (fast_tracepoint_jump_here (address))
+    {
+      free (signature);
+      free (commands);
+      return 0;
+    }
+
+  dp = xcalloc (1, sizeof (*dp));
+  dp->pid = ptid_get_pid (current_process ()->head.id);
+  dp->persist = persist;
+  dp->signature = signature;
+
+  tpoint = &dp->tpoint;
+  tpoint->type = fast_tracepoint;
+  tpoint->address = address;
+  tpoint->enabled = 1;
+  tpoint->orig_size = orig_size;
+  tpoint->cond = cond;
+  tpoint->numactions = ncommands;
+  tpoint->actions = xcalloc (ncommands, sizeof (*tpoint->actions));
+  for (i = 0; i < ncommands; i++)
+    {
+      struct eval_expr_action *action = xmalloc (sizeof (*action));
+
+      action->base.type = 'X';
+      action->base.ops = &x_tracepoint_action_ops;
+      action->expr = commands[i];
+      tpoint->actions[i] = &action->base;
+    }
+  free (commands);
+
+  /* Pause all threads while we patch the code, and make sure none is
+     in a jump pad, as in cmd_qtstart.  */
+  pause_all (0);
+  stabilize_threads ();
+  pause_all (1);
+
+  download_tracepoint_1 (tpoint);
+
+  /* Share the drain breakpoint with this process' other fast
+     dprintfs, if any.  */
+  dp->flush_bkpt = fast_dprintf_flush_bkpt (dp->pid);
+  if (dp->flush_bkpt == NULL)
+    dp->flush_bkpt
+      = set_breakpoint_at (ipa_sym_addrs.addr_flush_dprintf_buffer,
+			   flush_dprintf_buffer_handler);
+
+  *errbuf = '\0';
+  if (dp->flush_bkpt != NULL)
+    install_fast_tracepoint_1 (tpoint, ipa_sym_addrs.addr_gdb_dprintf_collect,
+			       dp->jump_insn, &dp->jump_insn_size, errbuf);
+
+  /* The IPA has its own copies of the condition and commands now.  */
+  tpoint->cond = NULL;
+  for (i = 0; i < tpoint->numactions; i++)
+    free (tpoint->actions[i]);
+  free (tpoint->actions);
+  tpoint->actions = NULL;
+  tpoint->numactions = 0;
+
+  if (tpoint->handle == NULL)
+    {
+      trace_debug ("Failed to install fast dprintf at 0x%s: %s",
+		   paddress (address), errbuf);
+      if (dp->flush_bkpt != NULL
+	  && fast_dprintf_flush_bkpt (dp->pid) == NULL)
+	delete_breakpoint (dp->flush_bkpt);
+      free (dp->signature);
+      free (dp);
+      unpause_all (1);
+      return 0;
+    }
+
+  dp->next = fast_dprintfs;
+  fast_dprintfs = dp;
+
+  /* The jump pad takes over from the trap.  */
+  delete_gdb_breakpoint_at (address);
+
+  unpause_all (1);
+
+  trace_debug ("Installed fast dprintf at 0x%s", paddress (address));
+  return 1;
+}
+
+/* Remove the fast dprintf at ADDRESS, if there is one inserted,
+   keeping its jump pad for when it is inserted again.  Return 1 if
+   one was removed, 0 otherwise.  */
+
+int
+remove_fast_dprintf (CORE_ADDR address)
+{
+  struct fast_dprintf *dp;
+
+  forget_exited_fast_dprintfs ();
+
+  dp = find_fast_dprintf (address);
+  if (dp == NULL || dp->tpoint.handle == NULL)
+    return 0;
+
+  pause_all (0);
+  stabilize_threads ();
+  pause_all (1);
+  /* Since we're removing breakpoints, cancel breakpoint hits,
+     possibly related to the breakpoints we're about to delete.  */
+  cancel_breakpoints ();
+
+  uninstall_fast_dprintf (dp);
+
+  unpause_all (1);
+  return 1;
+}
+
+/* Return true if the current process has fast dprintfs that should
+   keep running while GDB is disconnected.  */
+
+int
+any_persistent_fast_dprintfs (void)
+{
+  int pid = ptid_get_pid (current_process ()->head.id);
+  struct fast_dprintf *dp;
+
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->pid == pid && dp->persist && dp->tpoint.handle != NULL)
+      return 1;
+
+  return 0;
+}
+
 static void
 cmd_qtstop (char *packet)
 {
@@ -5449,18 +5938,24 @@ traceframe_read_info (int tfnum, struct buffer *buffer)
   return 0;
 }
 
-/* Return the first fast tracepoint whose jump pad contains PC.  */
+/* Return the first fast tracepoint whose jump pad contains PC.  Fast
+   dprintfs count as fast tracepoints here.  */
 
 static struct tracepoint *
 fast_tracepoint_from_jump_pad_address (CORE_ADDR pc)
 {
   struct tracepoint *tpoint;
+  struct fast_dprintf *dp;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     if (tpoint->type == fast_tracepoint)
       if (tpoint->jump_pad <= pc && pc < tpoint->jump_pad_end)
 	return tpoint;
 
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->tpoint.jump_pad <= pc && pc < dp->tpoint.jump_pad_end)
+      return &dp->tpoint;
+
   return NULL;
 }
 
@@ -5470,6 +5965,7 @@ static struct tracepoint *
 fast_tracepoint_from_trampoline_address (CORE_ADDR pc)
 {
   struct tracepoint *tpoint;
+  struct fast_dprintf *dp;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     {
@@ -5478,6 +5974,10 @@ fast_tracepoint_from_trampoline_address (CORE_ADDR pc)
 	return tpoint;
     }
 
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->tpoint.trampoline <= pc && pc < dp->tpoint.trampoline_end)
+      return &dp->tpoint;
+
   return NULL;
 }
 
@@ -5489,12 +5989,17 @@ static struct tracepoint *
 fast_tracepoint_from_ipa_tpoint_address (CORE_ADDR ipa_tpoint_obj)
 {
   struct tracepoint *tpoint;
+  struct fast_dprintf *dp;
 
   for (tpoint = tracepoints; tpoint; tpoint = tpoint->next)
     if (tpoint->type == fast_tracepoint)
       if (tpoint->obj_addr_on_target == ipa_tpoint_obj)
 	return tpoint;
 
+  for (dp = fast_dprintfs; dp != NULL; dp = dp->next)
+    if (dp->tpoint.obj_addr_on_target == ipa_tpoint_obj)
+      return &dp->tpoint;
+
   return NULL;
 }
 
@@ -5809,6 +6314,140 @@ gdb_collect (struct tracepoint *tpoint, unsigned char *regs)
     }
 }
 
+/* The output of the fast dprintfs, waiting for GDBserver to copy it
+   out.  DPRINTF_BUFFER_HEAD is only advanced by the IPA, and
+   DPRINTF_BUFFER_TAIL only by GDBserver; both run freely, and are
+   reduced modulo DPRINTF_BUFFER_SIZE to index the buffer.  */
+IP_AGENT_EXPORT char dprintf_buffer[DPRINTF_BUFFER_SIZE];
+IP_AGENT_EXPORT unsigned int dprintf_buffer_head;
+IP_AGENT_EXPORT volatile unsigned int dprintf_buffer_tail;
+
+/* Count of outputs that did not fit in the buffer.  */
+IP_AGENT_EXPORT unsigned int dprintf_buffer_dropped;
+
+/* True while gdb_dprintf_collect runs a dprintf's commands.  */
+static int collecting_dprintf;
+
+/* The time of the last call to flush_dprintf_buffer.  */
+static LONGEST last_dprintf_flush;
+
+/* Ask GDBserver to drain the dprintf buffer at least this often, in
+   microseconds, so that infrequent dprintfs show up promptly.  */
+#define DPRINTF_FLUSH_INTERVAL 100000
+
+static void
+call_flush_dprintf_buffer (void)
+{
+  last_dprintf_flush = get_timestamp ();
+  flush_dprintf_buffer ();
+}
+
+/* Write the output of an agent printf.  Output of fast dprintfs goes
+   to the dprintf buffer; anything else straight to stdout.  */
+
+void
+agent_printf_output (const char *text, int len)
+{
+  unsigned int head = dprintf_buffer_head;
+  unsigned int offset, chunk;
+
+  if (!collecting_dprintf)
+    {
+      fwrite (text, 1, len, stdout);
+      fflush (stdout);
+      return;
+    }
+
+  if (len > DPRINTF_BUFFER_SIZE - (head - dprintf_buffer_tail))
+    {
+      call_flush_dprintf_buffer ();
+      if (len > DPRINTF_BUFFER_SIZE - (head - dprintf_buffer_tail))
+	{
+	  dprintf_buffer_dropped++;
+	  return;
+	}
+    }
+
+  offset = head & (DPRINTF_BUFFER_SIZE - 1);
+  chunk = DPRINTF_BUFFER_SIZE - offset;
+  if (chunk > len)
+    chunk = len;
+  memcpy (dprintf_buffer + offset, text, chunk);
+  memcpy (dprintf_buffer, text + chunk, len - chunk);
+  dprintf_buffer_head = head + len;
+
+  if (dprintf_buffer_head - dprintf_buffer_tail >= DPRINTF_BUFFER_SIZE / 2
+      || get_timestamp () - last_dprintf_flush >= DPRINTF_FLUSH_INTERVAL)
+    call_flush_dprintf_buffer ();
+}
+
+/* Called from the jump pads of fast dprintfs.  Test TPOINT's
+   condition, and if true, run its commands.  Unlike gdb_collect,
+   this doesn't care whether a trace run is active, and errors are
+   not reported anywhere: a condition that fails to evaluate is
+   false.  */
+
+IP_AGENT_EXPORT void ATTR_USED
+gdb_dprintf_collect (struct tracepoint *tpoint, unsigned char *regs)
+{
+  struct fast_tracepoint_ctx ctx;
+  struct eval_agent_expr_context ax_ctx;
+  enum eval_result_type err;
+  ULONGEST value;
+  int i;
+
+  if (!tpoint->enabled)
+    return;
+
+  ctx.base.type = fast_tracepoint;
+  ctx.regs = regs;
+  ctx.regcache_initted = 0;
+  ctx.regspace = alloca (ipa_tdesc->registers_size);
+  ctx.tpoint = tpoint;
+
+  ax_ctx.regcache = NULL;
+  ax_ctx.tframe = NULL;
+  ax_ctx.tpoint = tpoint;
+
+  if (tpoint->cond != NULL)
+    {
+      value = 0;
+      if (tpoint->compiled_cond)
+	err = ((condfn) (uintptr_t) (tpoint->compiled_cond))
+	  ((struct tracepoint_hit_ctx *) &ctx, &value);
+      else
+	{
+	  ax_ctx.regcache
+	    = get_context_regcache ((struct tracepoint_hit_ctx *) &ctx);
+	  err = gdb_eval_agent_expr (&ax_ctx, tpoint->cond, &value);
+	}
+      if (err != expr_eval_no_error || value == 0)
+	return;
+    }
+
+  ax_ctx.regcache = get_context_regcache ((struct tracepoint_hit_ctx *) &ctx);
+
+  collecting_dprintf = 1;
+  for (i = 0; i < tpoint->numactions; i++)
+    {
+      struct eval_expr_action *eaction
+	= (struct eval_expr_action *) tpoint->actions[i];
+
+      gdb_eval_agent_expr (&ax_ctx, eaction->expr, &value);
+    }
+  collecting_dprintf = 0;
+}
+
+/* Give GDBserver a last chance to copy out pending dprintf output
+   when the program exits.  */
+
+static void __attribute__ ((destructor))
+flush_dprintf_buffer_at_exit (void)
+{
+  if (dprintf_buffer_head != dprintf_buffer_tail)
+    call_flush_dprintf_buffer ();
+}
+
 #endif
 
 #ifndef IN_PROCESS_AGENT
@@ -2163,6 +2163,9 @@ registers_info (char *addr_exp, int fpregs)
 
   if (!addr_exp)
     {
+      /* Fetch the registers the frames will unwind from in one go,
+	 rather than one at a time.  */
+      regcache_raw_update_all (get_current_regcache ());
       gdbarch_print_registers_info (gdbarch, gdb_stdout,
 				    frame, -1, fpregs);
       return;
@@ -1059,15 +1059,16 @@ static ptid_t deferred_step_ptid;
 
    In non-stop mode, we can have independent and simultaneous step
    requests, so more than one thread may need to simultaneously step
-   over a breakpoint.  The current implementation assumes there is
-   only one scratch space per process.  In this case, we have to
-   serialize access to the scratch space.  If thread A wants to step
-   over a breakpoint, but we are currently waiting for some other
-   thread to complete a displaced step, we leave thread A stopped and
-   place it in the displaced_step_request_queue.  Whenever a displaced
-   step finishes, we pick the next thread in the queue and start a new
-   displaced step operation on it.  See displaced_step_prepare and
-   displaced_step_fixup for details.  */
+   over a breakpoint.  The scratch space of each process is divided
+   into "set displaced-stepping-buffers" buffers, laid out one after
+   the other from gdbarch_displaced_step_location, and each buffer can
+   hold one thread's displaced step.  If thread A wants to step over a
+   breakpoint, but all the buffers are in use by other threads, we
+   leave thread A stopped and place it in the
+   displaced_step_request_queue.  Whenever a displaced step finishes,
+   we pick the next thread in the queue and start a new displaced step
+   operation on it, in the buffer just released.  See
+   displaced_step_prepare and displaced_step_fixup for details.  */
 
 struct displaced_step_request
 {
@@ -1075,21 +1076,11 @@ struct displaced_step_request
   struct displaced_step_request *next;
 };
 
-/* Per-inferior displaced stepping state.  */
-struct displaced_step_inferior_state
+/* One scratch buffer in which a displaced step can be carried out.  */
+struct displaced_step_buffer
 {
-  /* Pointer to next in linked list.  */
-  struct displaced_step_inferior_state *next;
-
-  /* The process this displaced step state refers to.  */
-  int pid;
-
-  /* A queue of pending displaced stepping requests.  One entry per
-     thread that needs to do a displaced step.  */
-  struct displaced_step_request *step_request_queue;
-
   /* If this is not null_ptid, this is the thread carrying out a
-     displaced single-step in process PID.  This thread's state will
+     displaced single-step in this buffer.  This thread's state will
      require fixing up once it has completed its step.  */
   ptid_t step_ptid;
 
@@ -1108,6 +1099,62 @@ struct displaced_step_inferior_state
   gdb_byte *step_saved_copy;
 };
 
+/* Per-inferior displaced stepping state.  */
+struct displaced_step_inferior_state
+{
+  /* Pointer to next in linked list.  */
+  struct displaced_step_inferior_state *next;
+
+  /* The process this displaced step state refers to.  */
+  int pid;
+
+  /* A queue of pending displaced stepping requests.  One entry per
+     thread that needs to do a displaced step.  */
+  struct displaced_step_request *step_request_queue;
+
+  /* The scratch buffers of process PID.  */
+  int nr_buffers;
+  struct displaced_step_buffer *buffers;
+};
+
+/* The most scratch buffers a process may use for displaced stepping.
+   The buffers overwrite the code at the scratch location, so keep
+   them to a small region.  */
+#define MAX_DISPLACED_STEP_BUFFERS 64
+
+/* The number of scratch buffers each process uses for displaced
+   stepping; that many threads can step over breakpoints at once.  */
+static unsigned int displaced_step_buffers = 1;
+static unsigned int displaced_step_buffers_1 = 1;
+
+static void
+set_displaced_step_buffers (char *args, int from_tty,
+			    struct cmd_list_element *c)
+{
+  if (displaced_step_buffers_1 == 0
+      || displaced_step_buffers_1 > MAX_DISPLACED_STEP_BUFFERS)
+    {
+      unsigned int value = displaced_step_buffers_1;
+
+      displaced_step_buffers_1 = displaced_step_buffers;
+      error (_("Invalid number of displaced stepping buffers %u; "
+	       "it must be between 1 and %d."),
+	     value, MAX_DISPLACED_STEP_BUFFERS);
+    }
+
+  displaced_step_buffers = displaced_step_buffers_1;
+}
+
+static void
+show_displaced_step_buffers (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file,
+		    _("The number of displaced stepping buffers "
+		      "per process is %s.\n"),
+		    value);
+}
+
 /* The list of states of processes involved in displaced stepping
    presently.  */
 static struct displaced_step_inferior_state *displaced_step_inferior_states;
@@ -1145,12 +1192,77 @@ add_displaced_stepping_state (int pid)
 
   state = xcalloc (1, sizeof (*state));
   state->pid = pid;
+  state->nr_buffers = displaced_step_buffers;
+  state->buffers = xcalloc (state->nr_buffers, sizeof (*state->buffers));
   state->next = displaced_step_inferior_states;
   displaced_step_inferior_states = state;
 
   return state;
 }
 
+/* Free the scratch buffers of DISPLACED, which must all be idle.  */
+
+static void
+free_displaced_step_buffers (struct displaced_step_inferior_state *displaced)
+{
+  int i;
+
+  for (i = 0; i < displaced->nr_buffers; i++)
+    xfree (displaced->buffers[i].step_saved_copy);
+  xfree (displaced->buffers);
+  displaced->buffers = NULL;
+  displaced->nr_buffers = 0;
+}
+
+/* Return the buffer in which thread PTID of DISPLACED is carrying out
+   a displaced step, or NULL if it is not doing one.  */
+
+static struct displaced_step_buffer *
+find_displaced_step_buffer (struct displaced_step_inferior_state *displaced,
+			    ptid_t ptid)
+{
+  int i;
+
+  if (displaced == NULL || ptid_equal (ptid, null_ptid))
+    return NULL;
+
+  for (i = 0; i < displaced->nr_buffers; i++)
+    if (ptid_equal (displaced->buffers[i].step_ptid, ptid))
+      return &displaced->buffers[i];
+
+  return NULL;
+}
+
+/* Return a buffer of DISPLACED that no thread is using, or NULL if
+   they are all busy.  */
+
+static struct displaced_step_buffer *
+find_free_displaced_step_buffer (struct displaced_step_inferior_state *displaced)
+{
+  int i;
+
+  for (i = 0; i < displaced->nr_buffers; i++)
+    if (ptid_equal (displaced->buffers[i].step_ptid, null_ptid))
+      return &displaced->buffers[i];
+
+  return NULL;
+}
+
+/* Return non-zero if any thread of DISPLACED is carrying out a
+   displaced step.  */
+
+static int
+displaced_step_in_progress (struct displaced_step_inferior_state *displaced)
+{
+  int i;
+
+  for (i = 0; i < displaced->nr_buffers; i++)
+    if (!ptid_equal (displaced->buffers[i].step_ptid, null_ptid))
+      return 1;
+
+  return 0;
+}
+
 /* If inferior is in displaced stepping, and ADDR equals to starting address
    of copy area, return corresponding displaced_step_closure.  Otherwise,
    return NULL.  */
@@ -1160,11 +1272,20 @@ get_displaced_step_closure_by_addr (CORE_ADDR addr)
 {
   struct displaced_step_inferior_state *displaced
     = get_displaced_stepping_state (ptid_get_pid (inferior_ptid));
+  int i;
+
+  if (displaced == NULL)
+    return NULL;
 
   /* If checking the mode of displaced instruction in copy area.  */
-  if (displaced && !ptid_equal (displaced->step_ptid, null_ptid)
-     && (displaced->step_copy == addr))
-    return displaced->step_closure;
+  for (i = 0; i < displaced->nr_buffers; i++)
+    {
+      struct displaced_step_buffer *buffer = &displaced->buffers[i];
+
+      if (!ptid_equal (buffer->step_ptid, null_ptid)
+	  && buffer->step_copy == addr)
+	return buffer->step_closure;
+    }
 
   return NULL;
 }
@@ -1185,6 +1306,7 @@ remove_displaced_stepping_state (int pid)
       if (it->pid == pid)
 	{
 	  *prev_next_p = it->next;
+	  free_displaced_step_buffers (it);
 	  xfree (it);
 	  return;
 	}
@@ -1240,25 +1362,25 @@ use_displaced_stepping (struct gdbarch *gdbarch)
 
 /* Clean out any stray displaced stepping state.  */
 static void
-displaced_step_clear (struct displaced_step_inferior_state *displaced)
+displaced_step_clear (struct displaced_step_buffer *buffer)
 {
   /* Indicate that there is no cleanup pending.  */
-  displaced->step_ptid = null_ptid;
+  buffer->step_ptid = null_ptid;
 
-  if (displaced->step_closure)
+  if (buffer->step_closure)
     {
-      gdbarch_displaced_step_free_closure (displaced->step_gdbarch,
-                                           displaced->step_closure);
-      displaced->step_closure = NULL;
+      gdbarch_displaced_step_free_closure (buffer->step_gdbarch,
+                                           buffer->step_closure);
+      buffer->step_closure = NULL;
     }
 }
 
 static void
 displaced_step_clear_cleanup (void *arg)
 {
-  struct displaced_step_inferior_state *state = arg;
+  struct displaced_step_buffer *buffer = arg;
 
-  displaced_step_clear (state);
+  displaced_step_clear (buffer);
 }
 
 /* Dump LEN bytes at BUF in hex to FILE, followed by a newline.  */
@@ -1299,6 +1421,7 @@ displaced_step_prepare (ptid_t ptid)
   ULONGEST len;
   struct displaced_step_closure *closure;
   struct displaced_step_inferior_state *displaced;
+  struct displaced_step_buffer *buffer;
   int status;
 
   /* We should never reach this function if the architecture does not
@@ -1311,15 +1434,27 @@ displaced_step_prepare (ptid_t ptid)
      jump/branch).  */
   tp->control.may_range_step = 0;
 
-  /* We have to displaced step one thread at a time, as we only have
-     access to a single scratch space per inferior.  */
+  /* We can only have as many threads displaced stepping at a time as
+     there are scratch buffers in the inferior.  */
 
   displaced = add_displaced_stepping_state (ptid_get_pid (ptid));
 
-  if (!ptid_equal (displaced->step_ptid, null_ptid))
+  /* Pick up a change of the number of buffers once they are all
+     idle.  */
+  if (displaced->nr_buffers != displaced_step_buffers
+      && !displaced_step_in_progress (displaced))
+    {
+      free_displaced_step_buffers (displaced);
+      displaced->nr_buffers = displaced_step_buffers;
+      displaced->buffers = xcalloc (displaced->nr_buffers,
+				    sizeof (*displaced->buffers));
+    }
+
+  buffer = find_free_displaced_step_buffer (displaced);
+  if (buffer == NULL)
     {
-      /* Already waiting for a displaced step to finish.  Defer this
-	 request and place in queue.  */
+      /* Already waiting for displaced steps to finish in all the
+	 buffers.  Defer this request and place in queue.  */
       struct displaced_step_request *req, *new_req;
 
       if (debug_displaced)
@@ -1352,21 +1487,23 @@ displaced_step_prepare (ptid_t ptid)
 			    target_pid_to_str (ptid));
     }
 
-  displaced_step_clear (displaced);
+  displaced_step_clear (buffer);
 
   old_cleanups = save_inferior_ptid ();
   inferior_ptid = ptid;
 
   original = regcache_read_pc (regcache);
 
-  copy = gdbarch_displaced_step_location (gdbarch);
   len = gdbarch_max_insn_length (gdbarch);
+  copy = (gdbarch_displaced_step_location (gdbarch)
+	  + (buffer - displaced->buffers) * len);
 
   /* Save the original contents of the copy area.  */
-  displaced->step_saved_copy = xmalloc (len);
+  xfree (buffer->step_saved_copy);
+  buffer->step_saved_copy = xmalloc (len);
   ignore_cleanups = make_cleanup (free_current_contents,
-				  &displaced->step_saved_copy);
-  status = target_read_memory (copy, displaced->step_saved_copy, len);
+				  &buffer->step_saved_copy);
+  status = target_read_memory (copy, buffer->step_saved_copy, len);
   if (status != 0)
     throw_error (MEMORY_ERROR,
 		 _("Error accessing memory address %s (%s) for "
@@ -1377,7 +1514,7 @@ displaced_step_prepare (ptid_t ptid)
       fprintf_unfiltered (gdb_stdlog, "displaced: saved %s: ",
 			  paddress (gdbarch, copy));
       displaced_step_dump_bytes (gdb_stdlog,
-				 displaced->step_saved_copy,
+				 buffer->step_saved_copy,
 				 len);
     };
 
@@ -1389,13 +1526,13 @@ displaced_step_prepare (ptid_t ptid)
 
   /* Save the information we need to fix things up if the step
      succeeds.  */
-  displaced->step_ptid = ptid;
-  displaced->step_gdbarch = gdbarch;
-  displaced->step_closure = closure;
-  displaced->step_original = original;
-  displaced->step_copy = copy;
+  buffer->step_ptid = ptid;
+  buffer->step_gdbarch = gdbarch;
+  buffer->step_closure = closure;
+  buffer->step_original = original;
+  buffer->step_copy = copy;
 
-  make_cleanup (displaced_step_clear_cleanup, displaced);
+  make_cleanup (displaced_step_clear_cleanup, buffer);
 
   /* Resume execution at the copy.  */
   regcache_write_pc (regcache, copy);
@@ -1425,18 +1562,36 @@ write_memory_ptid (ptid_t ptid, CORE_ADDR memaddr,
 /* Restore the contents of the copy area for thread PTID.  */
 
 static void
-displaced_step_restore (struct displaced_step_inferior_state *displaced,
-			ptid_t ptid)
+displaced_step_restore (struct displaced_step_buffer *buffer, ptid_t ptid)
 {
-  ULONGEST len = gdbarch_max_insn_length (displaced->step_gdbarch);
+  ULONGEST len = gdbarch_max_insn_length (buffer->step_gdbarch);
 
-  write_memory_ptid (ptid, displaced->step_copy,
-		     displaced->step_saved_copy, len);
+  write_memory_ptid (ptid, buffer->step_copy,
+		     buffer->step_saved_copy, len);
   if (debug_displaced)
     fprintf_unfiltered (gdb_stdlog, "displaced: restored %s %s\n",
 			target_pid_to_str (ptid),
-			paddress (displaced->step_gdbarch,
-				  displaced->step_copy));
+			paddress (buffer->step_gdbarch,
+				  buffer->step_copy));
+}
+
+/* Restore the contents of the copy areas of all the buffers of
+   DISPLACED that are in use, in process PTID.  A forked child inherits
+   every copy area its parent was using, not just the forking
+   thread's.  */
+
+static void
+displaced_step_restore_all (struct displaced_step_inferior_state *displaced,
+			    ptid_t ptid)
+{
+  int i;
+
+  if (displaced == NULL)
+    return;
+
+  for (i = 0; i < displaced->nr_buffers; i++)
+    if (!ptid_equal (displaced->buffers[i].step_ptid, null_ptid))
+      displaced_step_restore (&displaced->buffers[i], ptid);
 }
 
 static void
@@ -1445,29 +1600,26 @@ displaced_step_fixup (ptid_t event_ptid, enum gdb_signal signal)
   struct cleanup *old_cleanups;
   struct displaced_step_inferior_state *displaced
     = get_displaced_stepping_state (ptid_get_pid (event_ptid));
+  struct displaced_step_buffer *buffer;
 
-  /* Was any thread of this process doing a displaced step?  */
-  if (displaced == NULL)
-    return;
-
-  /* Was this event for the pid we displaced?  */
-  if (ptid_equal (displaced->step_ptid, null_ptid)
-      || ! ptid_equal (displaced->step_ptid, event_ptid))
+  /* Was this event for a thread we displaced?  */
+  buffer = find_displaced_step_buffer (displaced, event_ptid);
+  if (buffer == NULL)
     return;
 
-  old_cleanups = make_cleanup (displaced_step_clear_cleanup, displaced);
+  old_cleanups = make_cleanup (displaced_step_clear_cleanup, buffer);
 
-  displaced_step_restore (displaced, displaced->step_ptid);
+  displaced_step_restore (buffer, buffer->step_ptid);
 
   /* Did the instruction complete successfully?  */
   if (signal == GDB_SIGNAL_TRAP)
     {
       /* Fix up the resulting state.  */
-      gdbarch_displaced_step_fixup (displaced->step_gdbarch,
-                                    displaced->step_closure,
-                                    displaced->step_original,
-                                    displaced->step_copy,
-                                    get_thread_regcache (displaced->step_ptid));
+      gdbarch_displaced_step_fixup (buffer->step_gdbarch,
+                                    buffer->step_closure,
+                                    buffer->step_original,
+                                    buffer->step_copy,
+                                    get_thread_regcache (buffer->step_ptid));
     }
   else
     {
@@ -1476,13 +1628,13 @@ displaced_step_fixup (ptid_t event_ptid, enum gdb_signal signal)
       struct regcache *regcache = get_thread_regcache (event_ptid);
       CORE_ADDR pc = regcache_read_pc (regcache);
 
-      pc = displaced->step_original + (pc - displaced->step_copy);
+      pc = buffer->step_original + (pc - buffer->step_copy);
       regcache_write_pc (regcache, pc);
     }
 
   do_cleanups (old_cleanups);
 
-  displaced->step_ptid = null_ptid;
+  buffer->step_ptid = null_ptid;
 
   /* Are there any pending displaced stepping requests?  If so, run
      one now.  Leave the state object around, since we're likely to
@@ -1515,6 +1667,7 @@ displaced_step_fixup (ptid_t event_ptid, enum gdb_signal signal)
 				target_pid_to_str (ptid));
 
 	  displaced_step_prepare (ptid);
+	  buffer = find_displaced_step_buffer (displaced, ptid);
 
 	  gdbarch = get_regcache_arch (regcache);
 
@@ -1530,7 +1683,7 @@ displaced_step_fixup (ptid_t event_ptid, enum gdb_signal signal)
 	    }
 
 	  if (gdbarch_displaced_step_hw_singlestep (gdbarch,
-						    displaced->step_closure))
+						    buffer->step_closure))
 	    target_resume (ptid, 1, GDB_SIGNAL_0);
 	  else
 	    target_resume (ptid, 0, GDB_SIGNAL_0);
@@ -1585,8 +1738,11 @@ infrun_thread_ptid_changed (ptid_t old_ptid, ptid_t new_ptid)
        displaced;
        displaced = displaced->next)
     {
-      if (ptid_equal (displaced->step_ptid, old_ptid))
-	displaced->step_ptid = new_ptid;
+      int i;
+
+      for (i = 0; i < displaced->nr_buffers; i++)
+	if (ptid_equal (displaced->buffers[i].step_ptid, old_ptid))
+	  displaced->buffers[i].step_ptid = new_ptid;
 
       for (it = displaced->step_request_queue; it; it = it->next)
 	if (ptid_equal (it->ptid, old_ptid))
@@ -1788,7 +1944,7 @@ a command like `return' or `jump' to continue execution."));
       && sig == GDB_SIGNAL_0
       && !current_inferior ()->waiting_for_vfork_done)
     {
-      struct displaced_step_inferior_state *displaced;
+      struct displaced_step_buffer *buffer;
 
       if (!displaced_step_prepare (inferior_ptid))
 	{
@@ -1807,9 +1963,11 @@ a command like `return' or `jump' to continue execution."));
 	 instructions due to displaced stepping.  */
       pc = regcache_read_pc (get_thread_regcache (inferior_ptid));
 
-      displaced = get_displaced_stepping_state (ptid_get_pid (inferior_ptid));
+      buffer = find_displaced_step_buffer
+	(get_displaced_stepping_state (ptid_get_pid (inferior_ptid)),
+	 inferior_ptid);
       step = gdbarch_displaced_step_hw_singlestep (gdbarch,
-						   displaced->step_closure);
+						   buffer->step_closure);
     }
 
   /* Do we need to do it the hard way, w/temp breakpoints?  */
@@ -2643,7 +2801,7 @@ prepare_for_detach (void)
 
   /* Is any thread of this process displaced stepping?  If not,
      there's nothing else to do.  */
-  if (displaced == NULL || ptid_equal (displaced->step_ptid, null_ptid))
+  if (displaced == NULL || !displaced_step_in_progress (displaced))
     return;
 
   if (debug_infrun)
@@ -2653,7 +2811,7 @@ prepare_for_detach (void)
   old_chain_1 = make_cleanup_restore_integer (&inf->detaching);
   inf->detaching = 1;
 
-  while (!ptid_equal (displaced->step_ptid, null_ptid))
+  while (displaced_step_in_progress (displaced))
     {
       struct cleanup *old_chain_2;
       struct execution_control_state ecss;
@@ -3463,10 +3621,18 @@ handle_inferior_event (struct execution_control_state *ecs)
 	struct gdbarch *gdbarch = get_regcache_arch (regcache);
 	struct displaced_step_inferior_state *displaced
 	  = get_displaced_stepping_state (ptid_get_pid (ecs->ptid));
+	struct displaced_step_buffer *buffer
+	  = find_displaced_step_buffer (displaced, ecs->ptid);
+
+	/* The child of a fork gets a copy of every scratch pad in use,
+	   whichever thread forked.  Restore them all for the child
+	   before the parent's are released.  */
+	if (ecs->ws.kind == TARGET_WAITKIND_FORKED)
+	  displaced_step_restore_all (displaced, ecs->ws.value.related_pid);
 
 	/* If checking displaced stepping is supported, and thread
 	   ecs->ptid is displaced stepping.  */
-	if (displaced && ptid_equal (displaced->step_ptid, ecs->ptid))
+	if (buffer != NULL)
 	  {
 	    struct inferior *parent_inf
 	      = find_inferior_pid (ptid_get_pid (ecs->ptid));
@@ -3480,12 +3646,6 @@ handle_inferior_event (struct execution_control_state *ecs)
 	       because their pages are shared.  */
 	    displaced_step_fixup (ecs->ptid, GDB_SIGNAL_TRAP);
 
-	    if (ecs->ws.kind == TARGET_WAITKIND_FORKED)
-	      {
-		/* Restore scratch pad for child process.  */
-		displaced_step_restore (displaced, ecs->ws.value.related_pid);
-	      }
-
 	    /* Since the vfork/fork syscall instruction was executed in the scratchpad,
 	       the child's PC is also within the scratchpad.  Set the child's PC
 	       to the parent's PC value, which has already been fixed up.
@@ -7385,6 +7545,20 @@ use it in all-stop mode (see help set non-stop)."),
 				show_can_use_displaced_stepping,
 				&setlist, &showlist);
 
+  add_setshow_zuinteger_cmd ("displaced-stepping-buffers", class_run,
+			     &displaced_step_buffers_1, _("\
+Set the number of displaced stepping buffers per process."), _("\
+Show the number of displaced stepping buffers per process."), _("\
+Each buffer lets one more thread step over a breakpoint at the same time,\n\
+instead of waiting for the displaced steps of other threads to finish.\n\
+The buffers are placed one after the other at the architecture's scratch\n\
+location, usually the program's entry point, so more buffers overwrite\n\
+more of the code there while threads are stepping.\n\
+The number must be between 1 and 64."),
+			     set_displaced_step_buffers,
+			     show_displaced_step_buffers,
+			     &setlist, &showlist);
+
   add_setshow_enum_cmd ("exec-direction", class_run, exec_direction_names,
 			&exec_direction, _("Set direction of execution.\n\
 Options are 'forward' or 'reverse'."),
@@ -105,6 +105,21 @@ set_libthread_db_search_path (char *ignored, int from_tty,
 
 static unsigned int libthread_db_debug;
 
+/* Set to non-zero by the "set libthread-db-lazy-threads" command.
+   Live processes then have their threads listed from /proc/PID/task
+   instead of by walking libthread_db's thread list, and a thread's
+   libthread_db handle is only looked up when something needs it.  */
+
+static int libthread_db_lazy_threads;
+
+static void
+show_libthread_db_lazy_threads (struct ui_file *file, int from_tty,
+				struct cmd_list_element *c, const char *value)
+{
+  fprintf_filtered (file, _("Lazy lookup of libthread_db threads is %s.\n"),
+		    value);
+}
+
 static void
 show_libthread_db_debug (struct ui_file *file, int from_tty,
 			 struct cmd_list_element *c, const char *value)
@@ -1305,11 +1320,13 @@ attach_thread (ptid_t ptid, const td_thrhandle_t *th_p,
   info = get_thread_db_info (GET_PID (ptid));
 
   /* Enable thread event reporting for this thread, except when
-     debugging a core file.  */
+     debugging a core file.  Thread libraries that report no events
+     at all say so with TD_NOCAPAB; GDB learns of new LWPs from the
+     kernel anyway.  */
   if (target_has_execution)
     {
       err = info->td_thr_event_enable_p (th_p, 1);
-      if (err != TD_OK)
+      if (err != TD_OK && err != TD_NOCAPAB)
 	error (_("Cannot enable thread event reporting for %s: %s"),
 	       target_pid_to_str (ptid), thread_db_err_str (err));
     }
@@ -1653,6 +1670,133 @@ find_new_threads_once (struct thread_db_info *info, int iteration,
   return data.new_threads;
 }
 
+/* Callback for linux_proc_iterate_tasks.  Add LWP to GDB's thread
+   list if it is not there yet, attaching to it first.  DATA is a
+   struct callback_data.  */
+
+static int
+find_new_tasks_callback (pid_t lwp, void *data)
+{
+  struct callback_data *cb_data = data;
+  ptid_t ptid = ptid_build (cb_data->info->pid, lwp, 0);
+
+  if (find_thread_ptid (ptid) != NULL)
+    return 0;
+
+  /* If the LWP is gone, or not ready to be attached yet, skip it;
+     the next pass will see it again if it is still there.  */
+  if (lin_lwp_attach_lwp (ptid) != 0)
+    return 0;
+
+  add_thread (ptid);
+  cb_data->new_threads += 1;
+  return 0;
+}
+
+/* Look up the libthread_db handle of thread PTID, which GDB already
+   knows as an LWP, and record it in the thread's private data.  */
+
+static void
+thread_db_resolve_thread (ptid_t ptid)
+{
+  td_thrhandle_t th;
+  td_thrinfo_t ti;
+  td_err_e err;
+  struct thread_db_info *info;
+
+  info = get_thread_db_info (GET_PID (ptid));
+
+  /* Access an lwp we know is stopped.  */
+  info->proc_handle.ptid = ptid;
+
+  err = info->td_ta_map_lwp2thr_p (info->thread_agent, GET_LWP (ptid), &th);
+  if (err != TD_OK)
+    error (_("Cannot find user-level thread for LWP %ld: %s"),
+	   GET_LWP (ptid), thread_db_err_str (err));
+
+  err = info->td_thr_get_info_p (&th, &ti);
+  if (err != TD_OK)
+    error (_("Cannot get thread info for LWP %ld: %s"),
+	   GET_LWP (ptid), thread_db_err_str (err));
+
+  /* A thread ID of zero means libpthread has not initialized the
+     thread yet; see find_new_threads_callback.  */
+  if (ti.ti_tid != 0)
+    attach_thread (ptid, &th, &ti);
+}
+
+/* Like thread_db_resolve_thread, but only for a stopped thread with no
+   handle yet, and ignoring errors.  Returns the thread's private data,
+   or NULL if it is still unknown.  */
+
+static struct private_thread_info *
+thread_db_lazy_thread_info (struct thread_info *tp)
+{
+  volatile struct gdb_exception except;
+
+  if (tp->private == NULL
+      && !tp->executing
+      && get_thread_db_info (GET_PID (tp->ptid)) != NULL)
+    {
+      TRY_CATCH (except, RETURN_MASK_ERROR)
+	{
+	  thread_db_resolve_thread (tp->ptid);
+	}
+
+      if (except.reason < 0 && libthread_db_debug)
+	exception_fprintf (gdb_stderr, except,
+			   "Warning: thread_db_lazy_thread_info: ");
+    }
+
+  return tp->private;
+}
+
+/* Callback for iterate_over_threads.  Look up the handle of each
+   thread of process *DATA.  */
+
+static int
+lazy_thread_info_callback (struct thread_info *tp, void *data)
+{
+  int pid = *(int *) data;
+
+  if (ptid_get_pid (tp->ptid) == pid)
+    thread_db_lazy_thread_info (tp);
+
+  return 0;
+}
+
+/* The lazy version of thread_db_find_new_threads_2: list the LWPs of
+   the process from /proc instead, repeating until a pass finds no new
+   ones, since LWPs may clone while we look.  Then look up the handle
+   of PTID alone, which also checks that libthread_db works.  Returns
+   zero if /proc can not be read.  */
+
+static int
+thread_db_find_new_tasks (ptid_t ptid)
+{
+  struct callback_data data;
+  struct thread_info *tp;
+
+  data.info = get_thread_db_info (GET_PID (ptid));
+  do
+    {
+      data.new_threads = 0;
+      if (linux_proc_iterate_tasks (data.info->pid, find_new_tasks_callback,
+				    &data) < 0)
+	return 0;
+
+      if (libthread_db_debug)
+	printf_filtered (_("Found %d new LWPs.\n"), data.new_threads);
+    }
+  while (data.new_threads != 0);
+
+  tp = find_thread_ptid (ptid);
+  if (tp != NULL && tp->private == NULL)
+    thread_db_resolve_thread (ptid);
+
+  return 1;
+}
+
 /* Search for new threads, accessing memory through stopped thread
    PTID.  If UNTIL_NO_NEW is true, repeat searching until several
    searches in a row do not discover any new threads.  */
@@ -1664,6 +1808,10 @@ thread_db_find_new_threads_2 (ptid_t ptid, int until_no_new)
   struct thread_db_info *info;
   int i, loop;
 
+  if (libthread_db_lazy_threads && target_has_execution
+      && thread_db_find_new_tasks (ptid))
+    return;
+
   info = get_thread_db_info (GET_PID (ptid));
 
   /* Access an lwp we know is stopped.  */
@@ -1790,6 +1938,10 @@ thread_db_get_thread_local_address (struct target_ops *ops,
   /* Find the matching thread.  */
   thread_info = find_thread_ptid (ptid);
 
+  if (thread_info != NULL && thread_info->private == NULL
+      && libthread_db_lazy_threads)
+    thread_db_lazy_thread_info (thread_info);
+
   if (thread_info != NULL && thread_info->private != NULL)
     {
       td_err_e err;
@@ -1853,7 +2005,7 @@ thread_db_find_thread_from_tid (struct thread_info *thread, void *data)
 {
   long *tid = (long *) data;
 
-  if (thread->private->tid == *tid)
+  if (thread->private != NULL && thread->private->tid == *tid)
     return 1;
 
   return 0;
@@ -1867,6 +2019,12 @@ thread_db_get_ada_task_ptid (long lwp, long thread)
   struct thread_info *thread_info;
 
   thread_db_find_new_threads_1 (inferior_ptid);
+  if (libthread_db_lazy_threads)
+    {
+      int pid = ptid_get_pid (inferior_ptid);
+
+      iterate_over_threads (lazy_thread_info_callback, &pid);
+    }
   thread_info = iterate_over_threads (thread_db_find_thread_from_tid, &thread);
 
   gdb_assert (thread_info != NULL);
@@ -2099,6 +2257,18 @@ When non-zero, libthread-db debugging is enabled."),
 			     show_libthread_db_debug,
 			     &setdebuglist, &showdebuglist);
 
+  add_setshow_boolean_cmd ("libthread-db-lazy-threads", class_support,
+			   &libthread_db_lazy_threads, _("\
+Set whether threads are looked up in libthread_db only when needed."), _("\
+Show whether threads are looked up in libthread_db only when needed."), _("\
+If enabled, the threads of a live process are listed from /proc/PID/task,\n\
+rather than by walking the thread list of the thread library, which takes\n\
+many memory reads per thread.  A thread's libthread_db handle is then\n\
+looked up only when it is needed, for instance to access thread-local\n\
+storage; until then, the thread is shown by its LWP only."),
+			   NULL, show_libthread_db_lazy_threads,
+			   &setlist, &showlist);
+
   add_setshow_boolean_cmd ("libthread-db", class_support,
 			   &auto_load_thread_db, _("\
 Enable or disable auto-loading of inferior specific libthread_db."), _("\
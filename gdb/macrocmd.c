@@ -27,6 +27,7 @@
 #include "gdbcmd.h"
 #include "gdb_string.h"
 #include "linespec.h"
+#include "expression.h"
 
 
 /* The `macro' prefix command.  */
@@ -443,6 +444,9 @@ macro_define_command (char *exp, int from_tty)
       macro_define_object (macro_main (macro_user_macros), -1, name, exp);
     }
 
+  /* Expressions using the macro must be expanded afresh.  */
+  clear_expression_cache ();
+
   do_cleanups (cleanup_chain);
 }
 
@@ -460,6 +464,7 @@ macro_undef_command (char *exp, int from_tty)
   if (! name)
     error (_("Invalid macro name."));
   macro_undef (macro_main (macro_user_macros), -1, name);
+  clear_expression_cache ();
   xfree (name);
 }
 
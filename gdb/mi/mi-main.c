@@ -101,8 +101,6 @@ static void mi_execute_cli_command (const char *cmd, int args_p,
 				    const char *args);
 static void mi_execute_async_cli_command (char *cli_command, 
 					  char **argv, int argc);
-static int register_changed_p (int regnum, struct regcache *,
-			       struct regcache *);
 static void output_register (struct frame_info *, int regnum, int format,
 			     int skip_unavailable);
 
@@ -959,7 +957,8 @@ mi_cmd_data_list_changed_registers (char *command, char **argv, int argc)
   struct ui_out *uiout = current_uiout;
   struct regcache *prev_regs;
   struct gdbarch *gdbarch;
-  int regnum, numregs, changed;
+  int regnum, numregs;
+  gdb_byte *changed;
   int i;
   struct cleanup *cleanup;
 
@@ -982,6 +981,15 @@ mi_cmd_data_list_changed_registers (char *command, char **argv, int argc)
   gdbarch = get_regcache_arch (this_regs);
   numregs = gdbarch_num_regs (gdbarch) + gdbarch_num_pseudo_regs (gdbarch);
 
+  /* Find all the changed registers at once.  First time through or
+     after gdbarch change consider all registers as changed.  */
+  changed = xmalloc (numregs);
+  make_cleanup (xfree, changed);
+  if (prev_regs == NULL || get_regcache_arch (prev_regs) != gdbarch)
+    memset (changed, 1, numregs);
+  else
+    regcache_cooked_diff (prev_regs, this_regs, changed);
+
   make_cleanup_ui_out_list_begin_end (uiout, "changed-registers");
 
   if (argc == 0)
@@ -994,11 +1002,7 @@ mi_cmd_data_list_changed_registers (char *command, char **argv, int argc)
 	  if (gdbarch_register_name (gdbarch, regnum) == NULL
 	      || *(gdbarch_register_name (gdbarch, regnum)) == '\0')
 	    continue;
-	  changed = register_changed_p (regnum, prev_regs, this_regs);
-	  if (changed < 0)
-	    error (_("-data-list-changed-registers: "
-		     "Unable to read register contents."));
-	  else if (changed)
+	  if (changed[regnum])
 	    ui_out_field_int (uiout, NULL, regnum);
 	}
     }
@@ -1013,11 +1017,7 @@ mi_cmd_data_list_changed_registers (char *command, char **argv, int argc)
 	  && gdbarch_register_name (gdbarch, regnum) != NULL
 	  && *gdbarch_register_name (gdbarch, regnum) != '\000')
 	{
-	  changed = register_changed_p (regnum, prev_regs, this_regs);
-	  if (changed < 0)
-	    error (_("-data-list-changed-registers: "
-		     "Unable to read register contents."));
-	  else if (changed)
+	  if (changed[regnum])
 	    ui_out_field_int (uiout, NULL, regnum);
 	}
       else
@@ -1026,34 +1026,6 @@ mi_cmd_data_list_changed_registers (char *command, char **argv, int argc)
   do_cleanups (cleanup);
 }
 
-static int
-register_changed_p (int regnum, struct regcache *prev_regs,
-		    struct regcache *this_regs)
-{
-  struct gdbarch *gdbarch = get_regcache_arch (this_regs);
-  gdb_byte prev_buffer[MAX_REGISTER_SIZE];
-  gdb_byte this_buffer[MAX_REGISTER_SIZE];
-  enum register_status prev_status;
-  enum register_status this_status;
-
-  /* First time through or after gdbarch change consider all registers
-     as changed.  */
-  if (!prev_regs || get_regcache_arch (prev_regs) != gdbarch)
-    return 1;
-
-  /* Get register contents and compare.  */
-  prev_status = regcache_cooked_read (prev_regs, regnum, prev_buffer);
-  this_status = regcache_cooked_read (this_regs, regnum, this_buffer);
-
-  if (this_status != prev_status)
-    return 1;
-  else if (this_status == REG_VALID)
-    return memcmp (prev_buffer, this_buffer,
-		   register_size (gdbarch, regnum)) != 0;
-  else
-    return 0;
-}
-
 /* Return a list of register number and value pairs.  The valid
    arguments expected are: a letter indicating the format in which to
    display the registers contents.  This can be one of: x
@@ -1122,7 +1094,9 @@ mi_cmd_data_list_register_values (char *command, char **argv, int argc)
 
   if (argc - oind == 1)
     {
-      /* No args, beside the format: do all the regs.  */
+      /* No args, beside the format: do all the regs.  Fetch them from
+	 the target all at once.  */
+      regcache_raw_update_all (get_current_regcache ());
       for (regnum = 0;
 	   regnum < numregs;
 	   regnum++)
@@ -49,9 +49,29 @@ free_lzma (void *opaque, void *ptr)
 
 static lzma_allocator gdb_lzma_allocator = { alloc_lzma, free_lzma, NULL };
 
+/* The number of decompressed blocks kept in memory for each stream.
+   BFD reads the ELF header at the start of the data, the section
+   headers at its end and the sections in between, often going back and
+   forth between them; keeping a few blocks means each is usually
+   decompressed only once.  */
+
+#define LZMA_BLOCK_CACHE_SIZE 4
+
+/* A decompressed block.  */
+
+struct lzma_cached_block
+{
+  /* Uncompressed offsets of the start and end of the block.  */
+  bfd_size_type data_start;
+  bfd_size_type data_end;
+
+  /* The decompressed data, or NULL if this slot is unused.  */
+  gdb_byte *data;
+};
+
 /* Custom bfd_openr_iovec implementation to read compressed data from
-   a section.  This keeps only the last decompressed block in memory
-   to allow larger data without using to much memory.  */
+   a section.  This keeps only the last few decompressed blocks in
+   memory to allow larger data without using to much memory.  */
 
 struct lzma_stream
 {
@@ -61,10 +81,8 @@ struct lzma_stream
   /* lzma library decompression state.  */
   lzma_index *index;
 
-  /* Currently decoded block.  */
-  bfd_size_type data_start;
-  bfd_size_type data_end;
-  gdb_byte *data;
+  /* Recently decoded blocks, the most recently used first.  */
+  struct lzma_cached_block blocks[LZMA_BLOCK_CACHE_SIZE];
 };
 
 /* bfd_openr_iovec OPEN_P implementation for
@@ -142,13 +160,22 @@ lzma_pread (struct bfd *nbfd, void *stream, void *buf, file_ptr nbytes,
   lzma_filter filters[LZMA_FILTERS_MAX + 1];
   lzma_block block;
   size_t compressed_pos, uncompressed_pos;
+  struct lzma_cached_block *cached;
   file_ptr res;
+  int i;
 
   res = 0;
   while (nbytes > 0)
     {
-      if (lstream->data == NULL
-	  || lstream->data_start > offset || offset >= lstream->data_end)
+      for (i = 0; i < LZMA_BLOCK_CACHE_SIZE; i++)
+	{
+	  cached = &lstream->blocks[i];
+	  if (cached->data != NULL
+	      && cached->data_start <= offset && offset < cached->data_end)
+	    break;
+	}
+
+      if (i == LZMA_BLOCK_CACHE_SIZE)
 	{
 	  asection *section = lstream->section;
 
@@ -195,15 +222,29 @@ lzma_pread (struct bfd *nbfd, void *stream, void *buf, file_ptr nbytes,
 
 	  xfree (compressed);
 
-	  xfree (lstream->data);
-	  lstream->data = uncompressed;
-	  lstream->data_start = iter.block.uncompressed_file_offset;
-	  lstream->data_end = (iter.block.uncompressed_file_offset
-			       + iter.block.uncompressed_size);
+	  /* Replace the least recently used block.  */
+	  i = LZMA_BLOCK_CACHE_SIZE - 1;
+	  cached = &lstream->blocks[i];
+	  xfree (cached->data);
+	  cached->data = uncompressed;
+	  cached->data_start = iter.block.uncompressed_file_offset;
+	  cached->data_end = (iter.block.uncompressed_file_offset
+			      + iter.block.uncompressed_size);
+	}
+
+      /* Move the block to the front.  */
+      if (i > 0)
+	{
+	  struct lzma_cached_block tmp = *cached;
+
+	  memmove (&lstream->blocks[1], &lstream->blocks[0],
+		   i * sizeof (lstream->blocks[0]));
+	  lstream->blocks[0] = tmp;
+	  cached = &lstream->blocks[0];
 	}
 
-      chunk_size = min (nbytes, lstream->data_end - offset);
-      memcpy (buf, lstream->data + offset - lstream->data_start, chunk_size);
+      chunk_size = min (nbytes, cached->data_end - offset);
+      memcpy (buf, cached->data + offset - cached->data_start, chunk_size);
       buf = (gdb_byte *) buf + chunk_size;
       offset += chunk_size;
       nbytes -= chunk_size;
@@ -222,9 +263,11 @@ lzma_close (struct bfd *nbfd,
 	    void *stream)
 {
   struct lzma_stream *lstream = stream;
+  int i;
 
   lzma_index_end (lstream->index, &gdb_lzma_allocator);
-  xfree (lstream->data);
+  for (i = 0; i < LZMA_BLOCK_CACHE_SIZE; i++)
+    xfree (lstream->blocks[i].data);
   xfree (lstream);
 
   /* Zero means success.  */
@@ -51,6 +51,18 @@
 #include "cp-support.h"
 #include "language.h"
 #include "cli/cli-utils.h"
+#include "gdbcmd.h"
+#include "gdb_stat.h"
+#include "bcache.h"
+#include "version.h"
+#include "filestuff.h"
+#include <fcntl.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_FAILED
+#define MAP_FAILED ((void *) -1)
+#endif
+#endif
 
 /* Accumulate the minimal symbols for each objfile in bunches of BUNCH_SIZE.
    At the end, copy them all into one newly allocated location on an objfile's
@@ -1278,11 +1290,23 @@ terminate_minimal_symbol_table (struct objfile *objfile)
   }
 }
 
-/* Sort all the minimal symbols in OBJFILE.  */
+/* Sort all the minimal symbols in OBJFILE.  Relocating an objfile by
+   a uniform offset usually leaves the table in order; in that case
+   the entries have not moved, the hash chains still point at them,
+   and both the sort and the rehash are skipped.  */
 
 void
 msymbols_sort (struct objfile *objfile)
 {
+  int i;
+
+  for (i = 1; i < objfile->minimal_symbol_count; i++)
+    if (compare_minimal_symbols (&objfile->msymbols[i - 1],
+				 &objfile->msymbols[i]) > 0)
+      break;
+  if (i >= objfile->minimal_symbol_count)
+    return;
+
   qsort (objfile->msymbols, objfile->minimal_symbol_count,
 	 sizeof (struct minimal_symbol), compare_minimal_symbols);
   build_minimal_symbol_hash_tables (objfile);
@@ -1355,3 +1379,468 @@ find_solib_trampoline_target (struct frame_info *frame, CORE_ADDR pc)
     }
   return 0;
 }
+
+
+/* The on-disk cache of minimal symbols.  */
+
+/* The directory in which minimal symbols are cached, or NULL or empty
+   if they are not.  */
+
+static char *minsym_cache_directory;
+
+/* A cache file holds the minimal symbols of one objfile, as they were
+   after install_minimal_symbols, in a position-independent form that
+   can be used directly from a read-only mapping of the file.  All
+   numbers are little-endian; all strings are offsets into the string
+   table at the end of the file.
+
+   The header is:
+
+     8 bytes   MINSYM_CACHE_MAGIC
+     4 bytes   MINSYM_CACHE_FORMAT
+     4 bytes   number of symbols
+     4 bytes   offset of the string table
+     4 bytes   size of the string table
+     4 bytes   version of GDB that wrote the file
+     4 bytes   key the file was written for
+
+   It is followed by a record for each symbol:
+
+     8 bytes   address, before relocation
+     8 bytes   size
+     4 bytes   linkage name, with the target's leading character
+     4 bytes   source file name, or MINSYM_CACHE_NO_STRING
+     4 bytes   section index, or -1
+     1 byte    enum minimal_symbol_type
+     1 byte    MINSYM_CACHE_* flags
+     2 bytes   zero
+
+   The symbols are recorded afresh when the file is read, so names are
+   demangled and hashed just as for symbols read from the objfile.  */
+
+#define MINSYM_CACHE_MAGIC "GDBMSYM"
+#define MINSYM_CACHE_FORMAT 1
+#define MINSYM_CACHE_HEADER_SIZE 32
+#define MINSYM_CACHE_RECORD_SIZE 32
+#define MINSYM_CACHE_NO_STRING 0xffffffff
+
+#define MINSYM_CACHE_HAS_SIZE 0x1
+#define MINSYM_CACHE_CREATED_BY_GDB 0x2
+#define MINSYM_CACHE_TARGET_FLAG_1 0x4
+#define MINSYM_CACHE_TARGET_FLAG_2 0x8
+
+/* Return the name of the cache file for KEY, or NULL if minimal
+   symbols are not cached.  The result is xmalloc'd.  */
+
+static char *
+minsym_cache_file_name (const char *key)
+{
+  if (minsym_cache_directory == NULL || *minsym_cache_directory == '\0')
+    return NULL;
+
+  return concat (minsym_cache_directory, SLASH_STRING, key, ".msym",
+		 (char *) NULL);
+}
+
+/* Append STR to the string table being built in STRTAB, preceded by
+   LEADING_CHAR unless that is zero, and return its offset.  */
+
+static ULONGEST
+minsym_cache_add_string (struct obstack *strtab, int leading_char,
+			 const char *str)
+{
+  ULONGEST offset = obstack_object_size (strtab);
+
+  if (leading_char != 0)
+    obstack_1grow (strtab, leading_char);
+  obstack_grow0 (strtab, str, strlen (str));
+  return offset;
+}
+
+/* An entry in the table of file names written so far, so that each
+   file name is stored only once.  File names of minimal symbols are
+   shared through the objfile's filename cache, so they are compared
+   by address.  */
+
+struct minsym_cache_file_entry
+{
+  const char *filename;
+  ULONGEST offset;
+};
+
+static hashval_t
+hash_minsym_cache_file_entry (const void *p)
+{
+  const struct minsym_cache_file_entry *entry = p;
+
+  return htab_hash_pointer (entry->filename);
+}
+
+static int
+eq_minsym_cache_file_entry (const void *a, const void *b)
+{
+  const struct minsym_cache_file_entry *ea = a;
+  const struct minsym_cache_file_entry *eb = b;
+
+  return ea->filename == eb->filename;
+}
+
+/* See minsyms.h.  */
+
+void
+minimal_symbol_cache_write (struct objfile *objfile, const char *key)
+{
+  char *filename, *tmp_filename;
+  struct cleanup *cleanups;
+  struct obstack strtab;
+  htab_t filenames;
+  gdb_byte header[MINSYM_CACHE_HEADER_SIZE];
+  gdb_byte *records, *rec;
+  struct minimal_symbol *msym;
+  int leading_char = get_symbol_leading_char (objfile->obfd);
+  ULONGEST version_offset, key_offset, strtab_size;
+  FILE *file;
+  int ok;
+
+  filename = minsym_cache_file_name (key);
+  if (filename == NULL || objfile->minimal_symbol_count == 0)
+    {
+      xfree (filename);
+      return;
+    }
+  cleanups = make_cleanup (xfree, filename);
+
+  obstack_init (&strtab);
+  make_cleanup_obstack_free (&strtab);
+  filenames = htab_create_alloc (64, hash_minsym_cache_file_entry,
+				 eq_minsym_cache_file_entry, xfree,
+				 xcalloc, xfree);
+  make_cleanup_htab_delete (filenames);
+
+  version_offset = minsym_cache_add_string (&strtab, 0, version);
+  key_offset = minsym_cache_add_string (&strtab, 0, key);
+
+  records = xcalloc (objfile->minimal_symbol_count,
+		     MINSYM_CACHE_RECORD_SIZE);
+  make_cleanup (xfree, records);
+
+  rec = records;
+  ALL_OBJFILE_MSYMBOLS (objfile, msym)
+    {
+      int section = SYMBOL_SECTION (msym);
+      CORE_ADDR addr = SYMBOL_VALUE_ADDRESS (msym);
+      ULONGEST file_offset = MINSYM_CACHE_NO_STRING;
+      int flags = 0;
+
+      if (section >= 0)
+	addr -= ANOFFSET (objfile->section_offsets, section);
+
+      if (msym->filename != NULL)
+	{
+	  struct minsym_cache_file_entry entry, **slot;
+
+	  entry.filename = msym->filename;
+	  slot = (struct minsym_cache_file_entry **)
+	    htab_find_slot (filenames, &entry, INSERT);
+	  if (*slot == NULL)
+	    {
+	      *slot = XNEW (struct minsym_cache_file_entry);
+	      (*slot)->filename = msym->filename;
+	      (*slot)->offset = minsym_cache_add_string (&strtab, 0,
+							 msym->filename);
+	    }
+	  file_offset = (*slot)->offset;
+	}
+
+      if (MSYMBOL_HAS_SIZE (msym))
+	flags |= MINSYM_CACHE_HAS_SIZE;
+      if (msym->created_by_gdb)
+	flags |= MINSYM_CACHE_CREATED_BY_GDB;
+      if (MSYMBOL_TARGET_FLAG_1 (msym))
+	flags |= MINSYM_CACHE_TARGET_FLAG_1;
+      if (MSYMBOL_TARGET_FLAG_2 (msym))
+	flags |= MINSYM_CACHE_TARGET_FLAG_2;
+
+      bfd_putl64 (addr, rec);
+      bfd_putl64 (MSYMBOL_SIZE (msym), rec + 8);
+      bfd_putl32 (minsym_cache_add_string (&strtab, leading_char,
+					   SYMBOL_LINKAGE_NAME (msym)),
+		  rec + 16);
+      bfd_putl32 (file_offset, rec + 20);
+      bfd_putl32 (section, rec + 24);
+      rec[28] = MSYMBOL_TYPE (msym);
+      rec[29] = flags;
+      rec += MINSYM_CACHE_RECORD_SIZE;
+    }
+
+  /* Offsets are only 32 bits wide; don't bother caching anything
+     bigger than that.  */
+  strtab_size = obstack_object_size (&strtab);
+  if (strtab_size >= MINSYM_CACHE_NO_STRING)
+    {
+      do_cleanups (cleanups);
+      return;
+    }
+
+  memset (header, 0, sizeof (header));
+  memcpy (header, MINSYM_CACHE_MAGIC, sizeof (MINSYM_CACHE_MAGIC));
+  bfd_putl32 (MINSYM_CACHE_FORMAT, header + 8);
+  bfd_putl32 (objfile->minimal_symbol_count, header + 12);
+  bfd_putl32 (MINSYM_CACHE_HEADER_SIZE
+	      + rec - records, header + 16);
+  bfd_putl32 (strtab_size, header + 20);
+  bfd_putl32 (version_offset, header + 24);
+  bfd_putl32 (key_offset, header + 28);
+
+  /* Write to a temporary file and rename it into place, so that
+     another GDB never sees a partly written cache file.  The name
+     includes our pid so that GDBs caching the same file at the same
+     time do not write over each other's temporary file.  */
+  tmp_filename = xstrprintf ("%s.%ld.tmp", filename, (long) getpid ());
+  make_cleanup (xfree, tmp_filename);
+  file = gdb_fopen_cloexec (tmp_filename, FOPEN_WB);
+  if (file == NULL)
+    {
+      do_cleanups (cleanups);
+      return;
+    }
+
+  ok = (fwrite (header, sizeof (header), 1, file) == 1
+	&& fwrite (records, rec - records, 1, file) == 1
+	&& fwrite (obstack_base (&strtab), strtab_size, 1, file) == 1);
+  if (fclose (file) != 0)
+    ok = 0;
+  if (!ok || rename (tmp_filename, filename) != 0)
+    unlink (tmp_filename);
+  else if (symtab_create_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"Saved %d minimal symbols of objfile %s in %s.\n",
+			objfile->minimal_symbol_count, objfile->name,
+			filename);
+
+  do_cleanups (cleanups);
+}
+
+#ifdef HAVE_MMAP
+
+/* A cleanup that unmaps the mapping described by ARG.  */
+
+struct minsym_cache_map
+{
+  void *addr;
+  size_t len;
+};
+
+static void
+do_minsym_cache_munmap (void *arg)
+{
+  struct minsym_cache_map *map = arg;
+
+  munmap (map->addr, map->len);
+}
+
+#endif
+
+/* Check the records of the cache file DATA of SIZE bytes, which is
+   meant for KEY and OBJFILE.  Return the number of records, or -1 if
+   the file cannot be used.  */
+
+static LONGEST
+minsym_cache_check (struct objfile *objfile, const char *key,
+		    const gdb_byte *data, size_t size)
+{
+  ULONGEST count, strtab_offset, strtab_size, i;
+  const char *strtab;
+  const gdb_byte *rec;
+
+  if (size < MINSYM_CACHE_HEADER_SIZE
+      || memcmp (data, MINSYM_CACHE_MAGIC, sizeof (MINSYM_CACHE_MAGIC)) != 0
+      || bfd_getl32 (data + 8) != MINSYM_CACHE_FORMAT)
+    return -1;
+
+  count = bfd_getl32 (data + 12);
+  strtab_offset = bfd_getl32 (data + 16);
+  strtab_size = bfd_getl32 (data + 20);
+  if (strtab_offset != (MINSYM_CACHE_HEADER_SIZE
+			+ count * MINSYM_CACHE_RECORD_SIZE)
+      || strtab_size == 0
+      || strtab_offset + strtab_size != size)
+    return -1;
+
+  /* Since the string table ends with a NUL, any offset within it is
+     a valid string.  */
+  strtab = (const char *) data + strtab_offset;
+  if (strtab[strtab_size - 1] != '\0'
+      || bfd_getl32 (data + 24) >= strtab_size
+      || strcmp (strtab + bfd_getl32 (data + 24), version) != 0
+      || bfd_getl32 (data + 28) >= strtab_size
+      || strcmp (strtab + bfd_getl32 (data + 28), key) != 0)
+    return -1;
+
+  rec = data + MINSYM_CACHE_HEADER_SIZE;
+  for (i = 0; i < count; i++, rec += MINSYM_CACHE_RECORD_SIZE)
+    {
+      int section = (int) bfd_getl32 (rec + 24);
+      ULONGEST file_offset = bfd_getl32 (rec + 20);
+
+      if (bfd_getl32 (rec + 16) >= strtab_size
+	  || (file_offset != MINSYM_CACHE_NO_STRING
+	      && file_offset >= strtab_size)
+	  || section < -1 || section >= objfile->num_sections
+	  || rec[28] > mst_file_bss)
+	return -1;
+    }
+
+  return count;
+}
+
+/* See minsyms.h.  */
+
+int
+minimal_symbol_cache_read (struct objfile *objfile, const char *key)
+{
+  char *filename;
+  struct cleanup *cleanups;
+  struct stat st;
+  const gdb_byte *data = NULL;
+  const gdb_byte *rec;
+  const char *strtab;
+  size_t size;
+  LONGEST count, i;
+  int fd;
+
+  filename = minsym_cache_file_name (key);
+  if (filename == NULL)
+    return 0;
+  cleanups = make_cleanup (xfree, filename);
+
+  fd = gdb_open_cloexec (filename, O_RDONLY | O_BINARY, 0);
+  if (fd < 0)
+    {
+      do_cleanups (cleanups);
+      return 0;
+    }
+  make_cleanup_close (fd);
+
+  if (fstat (fd, &st) < 0 || st.st_size < MINSYM_CACHE_HEADER_SIZE)
+    {
+      do_cleanups (cleanups);
+      return 0;
+    }
+  size = st.st_size;
+
+#ifdef HAVE_MMAP
+  {
+    void *addr = mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (addr != MAP_FAILED)
+      {
+	struct minsym_cache_map *map = XNEW (struct minsym_cache_map);
+
+	map->addr = addr;
+	map->len = size;
+	make_cleanup_dtor (do_minsym_cache_munmap, map, xfree);
+	data = addr;
+      }
+  }
+#endif
+
+  if (data == NULL)
+    {
+      gdb_byte *buf = xmalloc (size);
+
+      make_cleanup (xfree, buf);
+      if (myread (fd, (char *) buf, size) != size)
+	{
+	  do_cleanups (cleanups);
+	  return 0;
+	}
+      data = buf;
+    }
+
+  /* Check the whole file before recording anything, so that a stale
+     or damaged file leaves the objfile to be read normally.  */
+  count = minsym_cache_check (objfile, key, data, size);
+  if (count < 0)
+    {
+      do_cleanups (cleanups);
+      return 0;
+    }
+
+  reserve_demangled_names (objfile, count);
+
+  strtab = (const char *) data + bfd_getl32 (data + 16);
+  rec = data + MINSYM_CACHE_HEADER_SIZE;
+  for (i = 0; i < count; i++, rec += MINSYM_CACHE_RECORD_SIZE)
+    {
+      CORE_ADDR addr = bfd_getl64 (rec);
+      const char *name = strtab + bfd_getl32 (rec + 16);
+      ULONGEST file_offset = bfd_getl32 (rec + 20);
+      int section = (int) bfd_getl32 (rec + 24);
+      int flags = rec[29];
+      struct minimal_symbol *msym;
+
+      if (section >= 0)
+	addr += ANOFFSET (objfile->section_offsets, section);
+
+      msym = prim_record_minimal_symbol_full (name, strlen (name), 1, addr,
+					      rec[28], section, objfile);
+      if (msym == NULL)
+	continue;
+
+      if (flags & MINSYM_CACHE_HAS_SIZE)
+	SET_MSYMBOL_SIZE (msym, bfd_getl64 (rec + 8));
+      msym->created_by_gdb = (flags & MINSYM_CACHE_CREATED_BY_GDB) != 0;
+      MSYMBOL_TARGET_FLAG_1 (msym) = (flags & MINSYM_CACHE_TARGET_FLAG_1) != 0;
+      MSYMBOL_TARGET_FLAG_2 (msym) = (flags & MINSYM_CACHE_TARGET_FLAG_2) != 0;
+      if (file_offset != MINSYM_CACHE_NO_STRING)
+	{
+	  const char *file = strtab + file_offset;
+
+	  msym->filename = bcache (file, strlen (file) + 1,
+				   objfile->per_bfd->filename_cache);
+	}
+    }
+
+  if (symtab_create_debug)
+    fprintf_unfiltered (gdb_stdlog,
+			"Read %s minimal symbols of objfile %s from %s.\n",
+			plongest (count), objfile->name, filename);
+
+  do_cleanups (cleanups);
+  return 1;
+}
+
+/* Implement "show minimal-symbol-cache-directory".  */
+
+static void
+show_minsym_cache_directory (struct ui_file *file, int from_tty,
+			     struct cmd_list_element *c, const char *value)
+{
+  if (*value == '\0')
+    fprintf_filtered (file, _("Minimal symbols are not cached.\n"));
+  else
+    fprintf_filtered (file, _("Minimal symbols are cached "
+			      "in \"%s\".\n"), value);
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_minsyms;
+
+void
+_initialize_minsyms (void)
+{
+  add_setshow_optional_filename_cmd ("minimal-symbol-cache-directory",
+				     class_support,
+				     &minsym_cache_directory, _("\
+Set the directory in which minimal symbols are cached."), _("\
+Show the directory in which minimal symbols are cached."), _("\
+If this is set to a directory, GDB saves the minimal symbols of each ELF\n\
+file with a build-id there.  The next time the same version of GDB loads\n\
+the file, it reads them back instead of the file's symbol tables.\n\
+GDB does not create the directory.\n\
+If empty, minimal symbols are always read from the file."),
+				     NULL,
+				     show_minsym_cache_directory,
+				     &setlist, &showlist);
+}
@@ -129,6 +129,21 @@ struct minimal_symbol *prim_record_minimal_symbol_and_info
 
 void install_minimal_symbols (struct objfile *);
 
+/* Record the minimal symbols saved for OBJFILE under KEY by
+   minimal_symbol_cache_write, as if the symbol reader had recorded
+   them itself.  KEY must identify the contents of OBJFILE's BFD.
+   Return non-zero if the symbols were found; if zero is returned,
+   nothing was recorded, and the caller should read the symbols from
+   the BFD.  */
+
+int minimal_symbol_cache_read (struct objfile *objfile, const char *key);
+
+/* Save the installed minimal symbols of OBJFILE under KEY, for use by
+   minimal_symbol_cache_read in this or a later session.  This does
+   nothing unless the user has enabled the cache.  */
+
+void minimal_symbol_cache_write (struct objfile *objfile, const char *key);
+
 /* Create the terminating entry of OBJFILE's minimal symbol table.
    If OBJFILE->msymbols is zero, allocate a single entry from
    OBJFILE->objfile_obstack; otherwise, just initialize
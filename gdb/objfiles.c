@@ -163,6 +163,8 @@ free_objfile_per_bfd_storage (struct objfile_per_bfd_storage *storage)
 {
   bcache_xfree (storage->filename_cache);
   bcache_xfree (storage->macro_cache);
+  if (storage->demangled_names_hash != NULL)
+    htab_delete (storage->demangled_names_hash);
   obstack_free (&storage->storage_obstack, 0);
 }
 
@@ -631,6 +633,7 @@ free_objfile (struct objfile *objfile)
      between expressions and which ought to be reset each time.  */
   expression_context_block = NULL;
   innermost_block = NULL;
+  clear_expression_cache ();
 
   /* Check to see if the current_source_symtab belongs to this objfile,
      and if so, call clear_current_source_symtab_and_line.  */
@@ -650,8 +653,6 @@ free_objfile (struct objfile *objfile)
     xfree (objfile->static_psymbols.list);
   /* Free the obstacks for non-reusable objfiles.  */
   psymbol_bcache_free (objfile->psymbol_cache);
-  if (objfile->demangled_names_hash)
-    htab_delete (objfile->demangled_names_hash);
   obstack_free (&objfile->objfile_obstack, 0);
 
   /* Rebuild section map next time we need it.  */
@@ -903,9 +904,13 @@ objfile_relocate (struct objfile *objfile,
       do_cleanups (my_cleanups);
     }
 
-  /* Relocate breakpoints as necessary, after things are relocated.  */
+  /* Relocate breakpoints as necessary, after things are relocated.
+     Parsed expressions may hold the old addresses of symbols.  */
   if (changed)
-    breakpoint_re_set ();
+    {
+      clear_expression_cache ();
+      breakpoint_re_set ();
+    }
 }
 
 /* Rebase (add to the offsets) OBJFILE by SLIDE.  SEPARATE_DEBUG_OBJFILE is
@@ -942,9 +947,13 @@ objfile_rebase (struct objfile *objfile, CORE_ADDR slide)
        debug_objfile = objfile_separate_debug_iterate (objfile, debug_objfile))
     changed |= objfile_rebase1 (debug_objfile, slide);
 
-  /* Relocate breakpoints as necessary, after things are relocated.  */
+  /* Relocate breakpoints as necessary, after things are relocated.
+     Parsed expressions may hold the old addresses of symbols.  */
   if (changed)
-    breakpoint_re_set ();
+    {
+      clear_expression_cache ();
+      breakpoint_re_set ();
+    }
 }
 
 /* Return non-zero if OBJFILE has partial symbols.  */
@@ -52,6 +52,7 @@
 #include "objfiles.h"
 #include "exceptions.h"
 #include "user-regs.h"
+#include "observer.h"
 
 /* Standard set of definitions for printing, dumping, prefixifying,
  * and evaluating expressions.  */
@@ -117,6 +118,49 @@ show_parserdebug (struct ui_file *file, int from_tty,
 
 static void free_funcalls (void *ignore);
 
+/* Parsed expressions are cached, so that text that is parsed over and
+   over again -- by breakpoint commands, Python's parse_and_eval,
+   MI's -data-evaluate-expression and the like -- is lexed and has
+   its symbols and types looked up only once.  An expression is a
+   flat array of elements whose only pointers are to symbols, blocks
+   and types owned by objfiles or architectures, and to internal
+   variables, so a copy of a cached expression is as good as a fresh
+   parse for as long as the symbol tables do not change.  The whole
+   cache is flushed when they do.
+
+   An entry's key is the text together with everything else the
+   parse depends on.  The PC matters to C's macro expansion.  */
+
+struct expression_cache_entry
+{
+  /* The text of the expression, or NULL if this entry is unused.  */
+  char *text;
+
+  const struct block *block;
+  CORE_ADDR pc;
+  const struct language_defn *lang;
+  struct gdbarch *gdbarch;
+  struct program_space *pspace;
+  unsigned input_radix;
+  enum case_sensitivity case_sensitivity;
+  int void_context_p;
+
+  /* The INNERMOST_BLOCK the parse found, had it started out NULL.  */
+  const struct block *innermost_block;
+
+  /* The parsed expression.  Callers get copies.  */
+  struct expression *exp;
+};
+
+#define EXPRESSION_CACHE_SIZE 64
+
+static struct expression_cache_entry expression_cache[EXPRESSION_CACHE_SIZE];
+
+/* The entry the next expression will be cached in.  */
+static int expression_cache_next;
+
+static int expression_cache_enabled = 1;
+
 static int prefixify_subexp (struct expression *, struct expression *, int,
 			     int);
 
@@ -1153,6 +1197,107 @@ parse_exp_in_context (const char **stringptr, CORE_ADDR pc,
   return expr;
 }
 
+/* Return a copy of expression EXP.  */
+
+static struct expression *
+copy_expression (const struct expression *exp)
+{
+  size_t size = sizeof (struct expression) + EXP_ELEM_TO_BYTES (exp->nelts);
+  struct expression *copy = xmalloc (size);
+
+  memcpy (copy, exp, size);
+  return copy;
+}
+
+/* Flush the expression cache.  */
+
+void
+clear_expression_cache (void)
+{
+  int i;
+
+  for (i = 0; i < EXPRESSION_CACHE_SIZE; i++)
+    {
+      xfree (expression_cache[i].text);
+      xfree (expression_cache[i].exp);
+      memset (&expression_cache[i], 0, sizeof (expression_cache[i]));
+    }
+}
+
+/* Merge BLOCK, the innermost block of a parse that started out with
+   no innermost block, into INNERMOST_BLOCK, the same way the parsers
+   update it.  */
+
+static void
+merge_innermost_block (const struct block *block)
+{
+  if (block != NULL
+      && (innermost_block == NULL || contained_in (block, innermost_block)))
+    innermost_block = block;
+}
+
+/* Look up the expression cache for the text STRING, parsed with the
+   key in KEY.  If found, return a copy of the cached expression,
+   otherwise return NULL.  */
+
+static struct expression *
+lookup_expression_cache (const char *string,
+			 const struct expression_cache_entry *key)
+{
+  int i;
+
+  for (i = 0; i < EXPRESSION_CACHE_SIZE; i++)
+    {
+      struct expression_cache_entry *e = &expression_cache[i];
+
+      if (e->text != NULL
+	  && e->block == key->block
+	  && e->pc == key->pc
+	  && e->lang == key->lang
+	  && e->gdbarch == key->gdbarch
+	  && e->pspace == key->pspace
+	  && e->input_radix == key->input_radix
+	  && e->case_sensitivity == key->case_sensitivity
+	  && e->void_context_p == key->void_context_p
+	  && strcmp (e->text, string) == 0)
+	{
+	  merge_innermost_block (e->innermost_block);
+	  return copy_expression (e->exp);
+	}
+    }
+
+  return NULL;
+}
+
+/* Add a copy of expression EXP, parsed from STRING with the key in
+   KEY, to the expression cache, evicting the oldest entry if the
+   cache is full.  */
+
+static void
+add_expression_cache (const char *string,
+		      const struct expression_cache_entry *key,
+		      const struct expression *exp)
+{
+  struct expression_cache_entry *e = &expression_cache[expression_cache_next];
+
+  xfree (e->text);
+  xfree (e->exp);
+  *e = *key;
+  e->text = xstrdup (string);
+  e->exp = copy_expression (exp);
+
+  expression_cache_next = (expression_cache_next + 1) % EXPRESSION_CACHE_SIZE;
+}
+
+/* Observer for the new_objfile event.  New symbols may change what
+   an expression's names refer to.  */
+
+static void
+expression_cache_new_objfile (struct objfile *objfile)
+{
+  clear_expression_cache ();
+}
+
 /* As for parse_exp_1, except that if VOID_CONTEXT_P, then
    no value is expected from the expression.
    OUT_SUBEXP is set when attempting to complete a field name; in this
@@ -1168,6 +1313,10 @@ parse_exp_in_context_1 (char **stringptr, CORE_ADDR pc,
   volatile struct gdb_exception except;
   struct cleanup *old_chain, *inner_chain;
   const struct language_defn *lang = NULL;
+  struct gdbarch *gdbarch;
+  struct expression_cache_entry key;
+  const struct block *saved_innermost_block = NULL;
+  int cacheable;
   int subexp;
 
   lexptr = *stringptr;
@@ -1240,7 +1389,42 @@ parse_exp_in_context_1 (char **stringptr, CORE_ADDR pc,
      While we need CURRENT_LANGUAGE to be set to LANG (for lookup_symbol
      and others called from *.y) ensure CURRENT_LANGUAGE gets restored
      to the value matching SELECTED_FRAME as set by get_current_arch.  */
-  initialize_expout (10, lang, get_current_arch ());
+  gdbarch = get_current_arch ();
+
+  /* Only whole expressions are cached; not those that may stop at a
+     comma, nor those parsed for completion.  Automatic overlay
+     debugging can remap the addresses of minimal symbols at any stop,
+     so nothing is cached then.  */
+  cacheable = (expression_cache_enabled && !comma && out_subexp == NULL
+	       && !parse_completion && overlay_debugging != ovly_auto);
+  if (cacheable)
+    {
+      struct expression *exp;
+
+      memset (&key, 0, sizeof (key));
+      key.block = expression_context_block;
+      key.pc = expression_context_pc;
+      key.lang = lang;
+      key.gdbarch = gdbarch;
+      key.pspace = current_program_space;
+      key.input_radix = input_radix;
+      key.case_sensitivity = case_sensitivity;
+      key.void_context_p = void_context_p;
+
+      exp = lookup_expression_cache (lexptr, &key);
+      if (exp != NULL)
+	{
+	  do_cleanups (old_chain);
+	  *stringptr = lexptr + strlen (lexptr);
+	  return exp;
+	}
+
+      /* Find out which innermost block this parse alone needs.  */
+      saved_innermost_block = innermost_block;
+      innermost_block = NULL;
+    }
+
+  initialize_expout (10, lang, gdbarch);
   inner_chain = make_cleanup_restore_current_language ();
   set_language (lang->la_language);
 
@@ -1254,6 +1438,12 @@ parse_exp_in_context_1 (char **stringptr, CORE_ADDR pc,
       if (! parse_completion)
 	{
 	  xfree (expout);
+	  if (cacheable)
+	    {
+	      key.innermost_block = innermost_block;
+	      innermost_block = saved_innermost_block;
+	      merge_innermost_block (key.innermost_block);
+	    }
 	  throw_exception (except);
 	}
     }
@@ -1279,6 +1469,18 @@ parse_exp_in_context_1 (char **stringptr, CORE_ADDR pc,
   do_cleanups (inner_chain);
   discard_cleanups (old_chain);
 
+  if (cacheable)
+    {
+      key.innermost_block = innermost_block;
+      innermost_block = saved_innermost_block;
+      merge_innermost_block (key.innermost_block);
+
+      /* Expressions followed by junk are an error for our callers;
+	 don't bother keeping them.  */
+      if (*lexptr == '\0')
+	add_expression_cache (*stringptr, &key, expout);
+    }
+
   *stringptr = lexptr;
   return expout;
 }
@@ -1932,6 +2134,19 @@ _initialize_parse (void)
 			     NULL,
 			     show_expressiondebug,
 			     &setdebuglist, &showdebuglist);
+  add_setshow_boolean_cmd ("expression-cache", class_maintenance,
+			   &expression_cache_enabled, _("\
+Set whether parsed expressions are cached."), _("\
+Show whether parsed expressions are cached."), _("\
+When enabled, the result of parsing an expression is remembered, and\n\
+reused when the same text is parsed again in the same context, until\n\
+the symbol tables change."),
+			   NULL,
+			   NULL,
+			   &maintenance_set_cmdlist,
+			   &maintenance_show_cmdlist);
+  observer_attach_new_objfile (expression_cache_new_objfile);
+
   add_setshow_boolean_cmd ("parser", class_maintenance,
 			    &parser_debug,
 			   _("Set parser debugging."),
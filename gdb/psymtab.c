@@ -791,7 +791,10 @@ relocate_psymtabs (struct objfile *objfile,
   struct partial_symbol **psym;
   struct partial_symtab *p;
 
-  ALL_OBJFILE_PSYMTABS_REQUIRED (objfile, p)
+  /* Do not force the partial symbols to be read just to relocate
+     them; if they are read later, the reader uses the objfile's new
+     section offsets.  */
+  for (p = objfile->psymtabs; p != NULL; p = p->next)
     {
       p->textlow += ANOFFSET (delta, SECT_OFF_TEXT (objfile));
       p->texthigh += ANOFFSET (delta, SECT_OFF_TEXT (objfile));
@@ -367,6 +367,24 @@ do_cooked_read (void *src, int regnum, gdb_byte *buf)
   return regcache_cooked_read (regcache, regnum, buf);
 }
 
+/* Return non-zero if saving REGCACHE will read every raw register it
+   does not hold yet, that is if each of them is in the save_reggroup.
+   Registers outside that group, such as large system register banks,
+   are then not fetched just to be thrown away.  */
+
+static int
+regcache_save_reads_all_raw (struct regcache *regcache)
+{
+  struct gdbarch *gdbarch = regcache->descr->gdbarch;
+  int regnum;
+
+  for (regnum = 0; regnum < regcache->descr->nr_raw_registers; regnum++)
+    if (regcache->register_status[regnum] == REG_UNKNOWN
+	&& !gdbarch_register_reggroup_p (gdbarch, regnum, save_reggroup))
+      return 0;
+  return 1;
+}
+
 void
 regcache_cpy (struct regcache *dst, struct regcache *src)
 {
@@ -376,7 +394,14 @@ regcache_cpy (struct regcache *dst, struct regcache *src)
   gdb_assert (src->readonly_p || dst->readonly_p);
 
   if (!src->readonly_p)
-    regcache_save (dst, do_cooked_read, src);
+    {
+      /* Fetch the registers in one go only when all of them are about
+	 to be read; otherwise read just the saved ones, one at a
+	 time.  */
+      if (regcache_save_reads_all_raw (src))
+	regcache_raw_update_all (src);
+      regcache_save (dst, do_cooked_read, src);
+    }
   else if (!dst->readonly_p)
     regcache_restore (dst, do_cooked_read, src);
   else
@@ -628,6 +653,35 @@ regcache_raw_read (struct regcache *regcache, int regnum, gdb_byte *buf)
   return regcache->register_status[regnum];
 }
 
+void
+regcache_raw_update_all (struct regcache *regcache)
+{
+  int nr_raw_registers;
+  struct cleanup *old_chain;
+  int regnum;
+
+  gdb_assert (regcache != NULL);
+  nr_raw_registers = regcache->descr->nr_raw_registers;
+
+  if (regcache->readonly_p)
+    return;
+
+  for (regnum = 0; regnum < nr_raw_registers; regnum++)
+    if (regcache->register_status[regnum] == REG_UNKNOWN)
+      break;
+  if (regnum == nr_raw_registers)
+    return;
+
+  /* Most targets transfer whole register sets anyway; this spares
+     those that don't one request per register.  Whatever the target
+     leaves unknown is retried one register at a time, and marked
+     unavailable, by regcache_raw_read.  */
+  old_chain = save_inferior_ptid ();
+  inferior_ptid = regcache->ptid;
+  target_fetch_registers (regcache, -1);
+  do_cleanups (old_chain);
+}
+
 enum register_status
 regcache_raw_read_signed (struct regcache *regcache, int regnum, LONGEST *val)
 {
@@ -694,6 +748,83 @@ regcache_raw_write_unsigned (struct regcache *regcache, int regnum,
   regcache_raw_write (regcache, regnum, buf);
 }
 
+/* Read cooked register REGNUM of the read-only REGCACHE into BUF,
+   and keep the value in REGCACHE if it had to be assembled from raw
+   registers.  Return its status.  */
+
+static enum register_status
+regcache_cooked_read_and_keep (struct regcache *regcache, int regnum,
+			       gdb_byte *buf)
+{
+  enum register_status status = regcache_cooked_read (regcache, regnum, buf);
+
+  gdb_assert (regcache->readonly_p);
+
+  if (regcache->register_status[regnum] == REG_UNKNOWN
+      && status != REG_UNKNOWN)
+    {
+      memcpy (register_buffer (regcache, regnum), buf,
+	      regcache->descr->sizeof_register[regnum]);
+      regcache->register_status[regnum] = status;
+    }
+
+  return status;
+}
+
+void
+regcache_cooked_diff (struct regcache *prev_regs, struct regcache *this_regs,
+		      gdb_byte *changed)
+{
+  struct regcache_descr *descr = this_regs->descr;
+  int raw_same;
+  int regnum;
+
+  gdb_assert (prev_regs->readonly_p && this_regs->readonly_p);
+  gdb_assert (prev_regs->descr == descr);
+
+  /* Usually few registers change from one stop to the next.  Compare
+     all the raw registers in two sweeps first; buffers are cleared
+     before saving, so equal registers have equal bytes.  */
+  raw_same = (memcmp (prev_regs->register_status, this_regs->register_status,
+		      descr->nr_raw_registers) == 0
+	      && memcmp (prev_regs->registers, this_regs->registers,
+			 descr->sizeof_raw_registers) == 0);
+
+  for (regnum = 0; regnum < descr->nr_cooked_registers; regnum++)
+    {
+      enum register_status prev_status = prev_regs->register_status[regnum];
+      enum register_status this_status = this_regs->register_status[regnum];
+      const gdb_byte *prev_buffer = register_buffer (prev_regs, regnum);
+      const gdb_byte *this_buffer = register_buffer (this_regs, regnum);
+
+      if (regnum < descr->nr_raw_registers && raw_same)
+	{
+	  changed[regnum] = 0;
+	  continue;
+	}
+
+      if (regnum >= descr->nr_raw_registers)
+	{
+	  /* Pseudo registers that were not saved are assembled from
+	     the raw ones.  Keep the result; THIS_REGS will be the
+	     previous registers next time.  */
+	  gdb_byte buf[MAX_REGISTER_SIZE];
+
+	  if (prev_status == REG_UNKNOWN)
+	    prev_status = regcache_cooked_read_and_keep (prev_regs, regnum,
+							 buf);
+	  if (this_status == REG_UNKNOWN)
+	    this_status = regcache_cooked_read_and_keep (this_regs, regnum,
+							 buf);
+	}
+
+      changed[regnum] = (prev_status != this_status
+			 || (this_status == REG_VALID
+			     && memcmp (prev_buffer, this_buffer,
+					descr->sizeof_register[regnum]) != 0));
+    }
+}
+
 enum register_status
 regcache_cooked_read (struct regcache *regcache, int regnum, gdb_byte *buf)
 {
@@ -72,6 +72,12 @@ enum register_status regcache_raw_read (struct regcache *regcache,
 					int rawnum, gdb_byte *buf);
 void regcache_raw_write (struct regcache *regcache, int rawnum,
 			 const gdb_byte *buf);
+
+/* Make sure every raw register of REGCACHE is fetched, asking the
+   target for all the unknown ones in a single request.  */
+
+extern void regcache_raw_update_all (struct regcache *regcache);
+
 extern enum register_status
   regcache_raw_read_signed (struct regcache *regcache,
 			    int regnum, LONGEST *val);
@@ -106,6 +112,15 @@ enum register_status regcache_cooked_read (struct regcache *regcache,
 void regcache_cooked_write (struct regcache *regcache, int rawnum,
 			    const gdb_byte *buf);
 
+/* Compare the read-only register caches PREV_REGS and THIS_REGS,
+   which must be of the same architecture, and set CHANGED[REGNUM] to
+   1 for each cooked register whose status or contents differ between
+   them, and to 0 for the others.  */
+
+extern void regcache_cooked_diff (struct regcache *prev_regs,
+				  struct regcache *this_regs,
+				  gdb_byte *changed);
+
 /* Read register REGNUM from REGCACHE and return a new value.  This
    will call mark_value_bytes_unavailable as appropriate.  */
 
@@ -423,6 +423,48 @@ one2one_register_sim_regno (struct gdbarch *gdbarch, int regnum)
   return regnum;
 }
 
+/* Supply register REGNO, whose value the simulator returned in BUF
+   along with size NR_BYTES, to REGCACHE.  */
+
+static void
+gdbsim_supply_register (struct regcache *regcache, int regno,
+			gdb_byte *buf, int nr_bytes)
+{
+  static int warn_user = 1;
+  struct gdbarch *gdbarch = get_regcache_arch (regcache);
+
+  if (nr_bytes > 0
+      && nr_bytes != register_size (gdbarch, regno) && warn_user)
+    {
+      fprintf_unfiltered (gdb_stderr,
+			  "Size of register %s (%d/%d) "
+			  "incorrect (%d instead of %d))",
+			  gdbarch_register_name (gdbarch, regno),
+			  regno,
+			  gdbarch_register_sim_regno (gdbarch, regno),
+			  nr_bytes, register_size (gdbarch, regno));
+      warn_user = 0;
+    }
+  /* FIXME: cagney/2002-05-27: Should check `nr_bytes == 0'
+     indicating that GDB and the SIM have different ideas about
+     which registers are fetchable.  */
+  /* Else if (nr_bytes < 0): an old simulator, that doesn't
+     think to return the register size.  Just assume all is ok.  */
+  regcache_raw_supply (regcache, regno, buf);
+  if (remote_debug)
+    {
+      printf_filtered ("gdbsim_fetch_register: %d", regno);
+      /* FIXME: We could print something more intelligible.  */
+      dump_mem (buf, register_size (gdbarch, regno));
+    }
+}
+
+/* Fetch registers from the simulator into REGCACHE.  Like the `g'
+   packet of the remote protocol, this always transfers all of the
+   raw registers, whatever REGNO is, in a single call to
+   sim_fetch_registers; filling a regcache then costs one trip across
+   the simulator interface per stop rather than one per register.  */
+
 static void
 gdbsim_fetch_register (struct target_ops *ops,
 		       struct regcache *regcache, int regno)
@@ -430,71 +472,46 @@ gdbsim_fetch_register (struct target_ops *ops,
   struct gdbarch *gdbarch = get_regcache_arch (regcache);
   struct sim_inferior_data *sim_data
     = get_sim_inferior_data (current_inferior (), SIM_INSTANCE_NEEDED);
-
-  if (regno == -1)
+  int num_regs = gdbarch_num_regs (gdbarch);
+  int *gdb_regnos = alloca (num_regs * sizeof (int));
+  int *sim_regnos = alloca (num_regs * sizeof (int));
+  int *lengths = alloca (num_regs * sizeof (int));
+  int *results = alloca (num_regs * sizeof (int));
+  gdb_byte **bufs = alloca (num_regs * sizeof (gdb_byte *));
+  gdb_byte *data = alloca (num_regs * MAX_REGISTER_SIZE);
+  int i, nr_regs = 0;
+
+  memset (data, 0, num_regs * MAX_REGISTER_SIZE);
+  for (regno = 0; regno < num_regs; regno++)
     {
-      for (regno = 0; regno < gdbarch_num_regs (gdbarch); regno++)
-	gdbsim_fetch_register (ops, regcache, regno);
-      return;
-    }
+      gdb_byte *buf = data + regno * MAX_REGISTER_SIZE;
 
-  switch (gdbarch_register_sim_regno (gdbarch, regno))
-    {
-    case LEGACY_SIM_REGNO_IGNORE:
-      break;
-    case SIM_REGNO_DOES_NOT_EXIST:
-      {
-	/* For moment treat a `does not exist' register the same way
-           as an ``unavailable'' register.  */
-	gdb_byte buf[MAX_REGISTER_SIZE];
-	int nr_bytes;
-
-	memset (buf, 0, MAX_REGISTER_SIZE);
-	regcache_raw_supply (regcache, regno, buf);
-	break;
-      }
-      
-    default:
-      {
-	static int warn_user = 1;
-	gdb_byte buf[MAX_REGISTER_SIZE];
-	int nr_bytes;
-
-	gdb_assert (regno >= 0 && regno < gdbarch_num_regs (gdbarch));
-	memset (buf, 0, MAX_REGISTER_SIZE);
-	nr_bytes = sim_fetch_register (sim_data->gdbsim_desc,
-				       gdbarch_register_sim_regno
-					 (gdbarch, regno),
-				       buf,
-				       register_size (gdbarch, regno));
-	if (nr_bytes > 0
-	    && nr_bytes != register_size (gdbarch, regno) && warn_user)
-	  {
-	    fprintf_unfiltered (gdb_stderr,
-				"Size of register %s (%d/%d) "
-				"incorrect (%d instead of %d))",
-				gdbarch_register_name (gdbarch, regno),
-				regno,
-				gdbarch_register_sim_regno
-				  (gdbarch, regno),
-				nr_bytes, register_size (gdbarch, regno));
-	    warn_user = 0;
-	  }
-	/* FIXME: cagney/2002-05-27: Should check `nr_bytes == 0'
-	   indicating that GDB and the SIM have different ideas about
-	   which registers are fetchable.  */
-	/* Else if (nr_bytes < 0): an old simulator, that doesn't
-	   think to return the register size.  Just assume all is ok.  */
-	regcache_raw_supply (regcache, regno, buf);
-	if (remote_debug)
-	  {
-	    printf_filtered ("gdbsim_fetch_register: %d", regno);
-	    /* FIXME: We could print something more intelligible.  */
-	    dump_mem (buf, register_size (gdbarch, regno));
-	  }
-	break;
-      }
+      switch (gdbarch_register_sim_regno (gdbarch, regno))
+	{
+	case LEGACY_SIM_REGNO_IGNORE:
+	  break;
+	case SIM_REGNO_DOES_NOT_EXIST:
+	  /* For moment treat a `does not exist' register the same way
+	     as an ``unavailable'' register.  */
+	  regcache_raw_supply (regcache, regno, buf);
+	  break;
+	default:
+	  gdb_regnos[nr_regs] = regno;
+	  sim_regnos[nr_regs] = gdbarch_register_sim_regno (gdbarch, regno);
+	  lengths[nr_regs] = register_size (gdbarch, regno);
+	  bufs[nr_regs] = buf;
+	  nr_regs++;
+	  break;
+	}
     }
+
+  if (nr_regs == 0)
+    return;
+
+  sim_fetch_registers (sim_data->gdbsim_desc, nr_regs, sim_regnos,
+		       bufs, lengths, results);
+  for (i = 0; i < nr_regs; i++)
+    gdbsim_supply_register (regcache, gdb_regnos[i], bufs[i], results[i]);
 }
 
 
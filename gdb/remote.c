@@ -127,6 +127,10 @@ static void remote_serial_write (const char *str, int len);
 
 static void remote_kill (struct target_ops *ops);
 
+static void remote_expedite_memory (void);
+
+static void clear_stop_memory (void);
+
 static int tohex (int nib);
 
 static int remote_can_async_p (void);
@@ -460,6 +464,60 @@ trace_error (char *buf)
     }
 }
 
+/* Handle a qRelocInsn request from the stub in BUF, of SIZEOF_BUF
+   bytes, by relocating the instruction, and send the reply.  */
+
+static void
+remote_relocate_insn_request (char *buf, long sizeof_buf)
+{
+  ULONGEST ul;
+  CORE_ADDR from, to, org_to;
+  char *p, *pp;
+  int adjusted_size = 0;
+  volatile struct gdb_exception ex;
+
+  p = buf + strlen ("qRelocInsn:");
+  pp = unpack_varlen_hex (p, &ul);
+  if (*pp != ';')
+    error (_("invalid qRelocInsn packet: %s"), buf);
+  from = ul;
+
+  p = pp + 1;
+  unpack_varlen_hex (p, &ul);
+  to = ul;
+
+  org_to = to;
+
+  TRY_CATCH (ex, RETURN_MASK_ALL)
+    {
+      gdbarch_relocate_instruction (target_gdbarch (), &to, from);
+    }
+  if (ex.reason >= 0)
+    {
+      adjusted_size = to - org_to;
+
+      xsnprintf (buf, sizeof_buf, "qRelocInsn:%x", adjusted_size);
+      putpkt (buf);
+    }
+  else if (ex.reason < 0 && ex.error == MEMORY_ERROR)
+    {
+      /* Propagate memory errors silently back to the target.
+	 The stub may have limited the range of addresses we
+	 can write to, for example.  */
+      putpkt ("E01");
+    }
+  else
+    {
+      /* Something unexpectedly bad happened.  Be verbose so
+	 we can tell what, and propagate the error back to the
+	 stub, so it doesn't get stuck waiting for a
+	 response.  */
+      exception_fprintf (gdb_stderr, ex,
+			 _("warning: relocating instruction: "));
+      putpkt ("E01");
+    }
+}
+
 /* Utility: wait for reply from stub, while accepting "O" packets.  */
 static char *
 remote_get_noisy_reply (char **buf_p,
@@ -475,54 +533,7 @@ remote_get_noisy_reply (char **buf_p,
       if (buf[0] == 'E')
 	trace_error (buf);
       else if (strncmp (buf, "qRelocInsn:", strlen ("qRelocInsn:")) == 0)
-	{
-	  ULONGEST ul;
-	  CORE_ADDR from, to, org_to;
-	  char *p, *pp;
-	  int adjusted_size = 0;
-	  volatile struct gdb_exception ex;
-
-	  p = buf + strlen ("qRelocInsn:");
-	  pp = unpack_varlen_hex (p, &ul);
-	  if (*pp != ';')
-	    error (_("invalid qRelocInsn packet: %s"), buf);
-	  from = ul;
-
-	  p = pp + 1;
-	  unpack_varlen_hex (p, &ul);
-	  to = ul;
-
-	  org_to = to;
-
-	  TRY_CATCH (ex, RETURN_MASK_ALL)
-	    {
-	      gdbarch_relocate_instruction (target_gdbarch (), &to, from);
-	    }
-	  if (ex.reason >= 0)
-	    {
-	      adjusted_size = to - org_to;
-
-	      xsnprintf (buf, *sizeof_buf, "qRelocInsn:%x", adjusted_size);
-	      putpkt (buf);
-	    }
-	  else if (ex.reason < 0 && ex.error == MEMORY_ERROR)
-	    {
-	      /* Propagate memory errors silently back to the target.
-		 The stub may have limited the range of addresses we
-		 can write to, for example.  */
-	      putpkt ("E01");
-	    }
-	  else
-	    {
-	      /* Something unexpectedly bad happened.  Be verbose so
-		 we can tell what, and propagate the error back to the
-		 stub, so it doesn't get stuck waiting for a
-		 response.  */
-	      exception_fprintf (gdb_stderr, ex,
-				 _("warning: relocating instruction: "));
-	      putpkt ("E01");
-	    }
-	}
+	remote_relocate_insn_request (buf, *sizeof_buf);
       else if (buf[0] == 'O' && buf[1] != 'K')
 	remote_console_output (buf + 1);	/* 'O' message from stub */
       else
@@ -1252,6 +1263,8 @@ packet_ok (const char *buf, struct packet_config *config)
 enum {
   PACKET_vCont = 0,
   PACKET_X,
+  PACKET_x,
+  PACKET_QExpediteMemory,
   PACKET_qSymbol,
   PACKET_P,
   PACKET_p,
@@ -1295,6 +1308,7 @@ enum {
   PACKET_ConditionalTracepoints,
   PACKET_ConditionalBreakpoints,
   PACKET_BreakpointCommands,
+  PACKET_FastBreakpointCommands,
   PACKET_FastTracepoints,
   PACKET_StaticTracepoints,
   PACKET_InstallInTrace,
@@ -1754,6 +1768,89 @@ remote_program_signals (int numsigs, unsigned char *signals)
     }
 }
 
+/* How many bytes of memory at the stack pointer and at the program
+   counter the stub should send along with each stop reply.  */
+
+static unsigned int remote_stop_reply_stack_size = 128;
+static unsigned int remote_stop_reply_code_size = 32;
+
+/* The last QExpediteMemory packet sent to the target.  Like the
+   signal lists above, we only let the target know about changes.  */
+
+static char *last_expedite_memory_packet;
+
+/* The stub widens each expedited block outwards to a multiple of this
+   many bytes.  A stop is only served from the blocks for reads that
+   start inside them, and aligning the start down lets reads that begin
+   a little below the register also hit: the bytes just before the PC
+   that are inspected after a breakpoint trap, or the red zone below
+   the stack pointer.  64 bytes keeps that widening small.  */
+
+#define EXPEDITE_MEMORY_ALIGN 64
+
+/* Append a "REGNO,LEN,ALIGN" request for LEN bytes at the value of
+   GDB register REGNUM to the QExpediteMemory packet at P, if the
+   register is known to the target.  Returns the new end of the
+   packet.  */
+
+static char *
+add_expedite_memory_request (char *p, int regnum, unsigned int len)
+{
+  struct remote_arch_state *rsa = get_remote_arch_state ();
+  struct packet_reg *reg;
+
+  if (len == 0
+      || regnum < 0 || regnum >= gdbarch_num_regs (target_gdbarch ()))
+    return p;
+
+  reg = packet_reg_from_regnum (rsa, regnum);
+  if (p[-1] != ':')
+    *p++ = ';';
+  return p + sprintf (p, "%s,%x,%x", phex_nz (reg->pnum, 0), len,
+		     EXPEDITE_MEMORY_ALIGN);
+}
+
+/* If 'QExpediteMemory' is supported, ask the remote stub to send the
+   memory around the stack pointer and the program counter along with
+   each stop reply, so that reporting a stop takes no further round
+   trips.  Only done in all-stop mode, where that memory can not change
+   until the target is resumed.  */
+
+static void
+remote_expedite_memory (void)
+{
+  struct gdbarch *gdbarch = target_gdbarch ();
+  char *packet, *p;
+
+  if (non_stop
+      || remote_protocol_packets[PACKET_QExpediteMemory].support
+	 == PACKET_DISABLE)
+    return;
+
+  packet = xmalloc (strlen ("QExpediteMemory:") + 2 * 32);
+  p = packet + sprintf (packet, "QExpediteMemory:");
+  p = add_expedite_memory_request (p, gdbarch_sp_regnum (gdbarch),
+				   min (remote_stop_reply_stack_size, 512));
+  p = add_expedite_memory_request (p, gdbarch_pc_regnum (gdbarch),
+				   min (remote_stop_reply_code_size, 512));
+  *p = '\0';
+
+  if (!last_expedite_memory_packet
+      || strcmp (last_expedite_memory_packet, packet) != 0)
+    {
+      struct remote_state *rs = get_remote_state ();
+
+      putpkt (packet);
+      getpkt (&rs->buf, &rs->buf_size, 0);
+      packet_ok (rs->buf,
+		 &remote_protocol_packets[PACKET_QExpediteMemory]);
+      xfree (last_expedite_memory_packet);
+      last_expedite_memory_packet = packet;
+    }
+  else
+    xfree (packet);
+}
+
 /* What type of 'H' packet? */
 enum H_packet_type
 {
@@ -3058,6 +3155,8 @@ remote_close (void)
   serial_close (remote_desc);
   remote_desc = NULL;
 
+  clear_stop_memory ();
+
   /* We don't have a connection to the remote stub anymore.  Get rid
      of all the inferiors and their threads we were controlling.
      Reset inferior_ptid to null_ptid first, as otherwise has_stack_frame
@@ -4031,6 +4130,11 @@ static struct protocol_feature remote_protocol_features[] = {
     PACKET_ConditionalBreakpoints },
   { "BreakpointCommands", PACKET_DISABLE, remote_breakpoint_commands_feature,
     PACKET_BreakpointCommands },
+  { "FastBreakpointCommands", PACKET_DISABLE, remote_supported_packet,
+    PACKET_FastBreakpointCommands },
+  { "binary-upload", PACKET_DISABLE, remote_supported_packet, PACKET_x },
+  { "QExpediteMemory", PACKET_DISABLE, remote_supported_packet,
+    PACKET_QExpediteMemory },
   { "FastTracepoints", PACKET_DISABLE, remote_fast_tracepoint_feature,
     PACKET_FastTracepoints },
   { "StaticTracepoints", PACKET_DISABLE, remote_static_tracepoint_feature,
@@ -4296,6 +4400,10 @@ remote_open_1 (char *name, int from_tty,
   xfree (last_program_signals_packet);
   last_program_signals_packet = NULL;
 
+  /* Likewise the memory to expedite in stop replies.  */
+  xfree (last_expedite_memory_packet);
+  last_expedite_memory_packet = NULL;
+
   remote_fileio_reset ();
   reopen_exec_file ();
   reread_symbols ();
@@ -4937,6 +5045,10 @@ remote_resume (struct target_ops *ops,
   if (!non_stop)
     remote_notif_process (&notif_client_stop);
 
+  /* Memory expedited by the last stop is about to go stale.  */
+  clear_stop_memory ();
+  remote_expedite_memory ();
+
   last_sent_signal = siggnal;
   last_sent_step = step;
 
@@ -5270,6 +5382,74 @@ typedef struct cached_reg
 
 DEF_VEC_O(cached_reg_t);
 
+/* A block of target memory sent along with a stop reply, as asked for
+   with the QExpediteMemory packet.  */
+
+typedef struct expedited_mem
+{
+  CORE_ADDR addr;
+  int len;
+  gdb_byte *data;
+} expedited_mem_t;
+
+DEF_VEC_O(expedited_mem_t);
+
+/* Free the vector of memory blocks *VECP, and their contents.  */
+
+static void
+free_expedited_memory (VEC(expedited_mem_t) **vecp)
+{
+  expedited_mem_t *mem;
+  int ix;
+
+  for (ix = 0; VEC_iterate (expedited_mem_t, *vecp, ix, mem); ix++)
+    xfree (mem->data);
+  VEC_free (expedited_mem_t, *vecp);
+}
+
+/* The memory expedited by the stop reply that was last reported to
+   the core, and the process it belongs to.  In all-stop mode it
+   stays valid until the target is resumed or its memory is
+   written.  */
+
+static VEC(expedited_mem_t) *stop_memory;
+static int stop_memory_pid;
+
+static void
+clear_stop_memory (void)
+{
+  free_expedited_memory (&stop_memory);
+}
+
+/* Try to satisfy a read of LEN bytes at MEMADDR into MYADDR from the
+   memory expedited by the last stop.  Returns the number of bytes
+   read, which may be fewer than LEN, or 0 if MEMADDR is not
+   covered.  */
+
+static int
+read_stop_memory (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
+{
+  expedited_mem_t *mem;
+  int ix;
+
+  if (stop_memory == NULL
+      || ptid_get_pid (inferior_ptid) != stop_memory_pid
+      || get_traceframe_number () != -1)
+    return 0;
+
+  for (ix = 0; VEC_iterate (expedited_mem_t, stop_memory, ix, mem); ix++)
+    if (memaddr >= mem->addr && memaddr - mem->addr < mem->len)
+      {
+	int offset = memaddr - mem->addr;
+
+	len = min (len, mem->len - offset);
+	memcpy (myaddr, mem->data + offset, len);
+	return len;
+      }
+
+  return 0;
+}
+
 typedef struct stop_reply
 {
   struct notif_event base;
@@ -5285,6 +5465,9 @@ typedef struct stop_reply
      fetch them is avoided).  */
   VEC(cached_reg_t) *regcache;
 
+  /* Expedited memory, likewise.  */
+  VEC(expedited_mem_t) *memory;
+
   int stopped_by_watchpoint_p;
   CORE_ADDR watch_data_address;
 
@@ -5311,6 +5494,7 @@ stop_reply_xfree (struct stop_reply *r)
   if (r != NULL)
     {
       VEC_free (cached_reg_t, r->regcache);
+      free_expedited_memory (&r->memory);
       xfree (r);
     }
 }
@@ -5356,6 +5540,7 @@ stop_reply_dtr (struct notif_event *event)
   struct stop_reply *r = (struct stop_reply *) event;
 
   VEC_free (cached_reg_t, r->regcache);
+  free_expedited_memory (&r->memory);
 }
 
 static struct notif_event *
@@ -5554,6 +5739,7 @@ remote_parse_stop_reply (char *buf, struct stop_reply *event)
   event->replay_event = 0;
   event->stopped_by_watchpoint_p = 0;
   event->regcache = NULL;
+  event->memory = NULL;
   event->core = -1;
 
   switch (buf[0])
@@ -5635,6 +5821,29 @@ Packet: '%s'\n"),
 		  p = unpack_varlen_hex (++p1, &c);
 		  event->core = c;
 		}
+	      else if (strncmp (p, "memory", p1 - p) == 0)
+		{
+		  expedited_mem_t mem;
+
+		  p = unpack_varlen_hex (++p1, &addr);
+		  if (*p++ != ',')
+		    error (_("Malformed expedited memory in stop reply: %s"),
+			   buf);
+		  p_temp = strchr (p, ';');
+		  if (p_temp == NULL)
+		    p_temp = p + strlen (p);
+		  mem.addr = (CORE_ADDR) addr;
+		  mem.len = (p_temp - p) / 2;
+		  mem.data = xmalloc (mem.len);
+		  if (hex2bin (p, mem.data, mem.len) != mem.len)
+		    {
+		      xfree (mem.data);
+		      error (_("Malformed expedited memory in stop reply: %s"),
+			     buf);
+		    }
+		  VEC_safe_push (expedited_mem_t, event->memory, &mem);
+		  p = p_temp;
+		}
 	      else
 		{
 		  /* Silently skip unknown optional info.  */
@@ -5862,6 +6071,15 @@ process_stop_reply (struct stop_reply *stop_reply,
 	  VEC_free (cached_reg_t, stop_reply->regcache);
 	}
 
+      /* Expedited memory.  */
+      clear_stop_memory ();
+      if (!non_stop)
+	{
+	  stop_memory = stop_reply->memory;
+	  stop_memory_pid = ptid_get_pid (ptid);
+	  stop_reply->memory = NULL;
+	}
+
       remote_stopped_by_watchpoint_p = stop_reply->stopped_by_watchpoint_p;
       remote_watch_data_address = stop_reply->watch_data_address;
 
@@ -6770,6 +6988,9 @@ remote_write_bytes_aux (const char *header, CORE_ADDR memaddr,
   if (len <= 0)
     return 0;
 
+  /* The memory expedited by the last stop may cover MEMADDR.  */
+  clear_stop_memory ();
+
   payload_size = get_memory_write_packet_size ();
 
   /* The packet buffer will be large enough for the payload;
@@ -6957,10 +7178,45 @@ remote_read_bytes (CORE_ADDR memaddr, gdb_byte *myaddr, int len)
   if (len <= 0)
     return 0;
 
+  todo = read_stop_memory (memaddr, myaddr, len);
+  if (todo > 0)
+    return todo;
+
   max_buf_size = get_memory_read_packet_size ();
   /* The packet buffer will be large enough for the payload;
      get_memory_packet_size ensures this.  */
 
+  /* If the target can send memory in binary, ask for as many bytes
+     as fit unescaped; it sends fewer if escapes don't leave room.  */
+  if (remote_protocol_packets[PACKET_x].support == PACKET_ENABLE)
+    {
+      int reply_len;
+
+      todo = min (len, max_buf_size);
+
+      /* Construct "x"<memaddr>","<len>".  */
+      memaddr = remote_address_masked (memaddr);
+      p = rs->buf;
+      *p++ = 'x';
+      p += hexnumstr (p, (ULONGEST) memaddr);
+      *p++ = ',';
+      p += hexnumstr (p, (ULONGEST) todo);
+      *p = '\0';
+      putpkt (rs->buf);
+      reply_len = getpkt_sane (&rs->buf, &rs->buf_size, 0);
+
+      /* The data is prefixed with 'b', so that it can't be taken for
+	 an error reply.  */
+      if (reply_len < 1 || rs->buf[0] != 'b')
+	{
+	  errno = EIO;
+	  return 0;
+	}
+
+      return remote_unescape_input ((gdb_byte *) rs->buf + 1, reply_len - 1,
+				    myaddr, todo);
+    }
+
   /* Number if bytes that will fit.  */
   todo = min (len, max_buf_size / 2);
 
@@ -7896,6 +8152,8 @@ extended_remote_mourn_1 (struct target_ops *target)
 {
   struct remote_state *rs = get_remote_state ();
 
+  clear_stop_memory ();
+
   /* In case we got here due to an error, but we're going to stay
      connected.  */
   rs->waiting_for_stop_reply = 0;
@@ -8175,6 +8433,26 @@ remote_add_target_side_commands (struct gdbarch *gdbarch,
   VEC_free (agent_expr_p, bp_tgt->tcommands);
 }
 
+/* Return the length of the instruction at ADDR, if the target could
+   replace it by a jump to run breakpoint commands, or 0 otherwise.  */
+
+static int
+remote_fast_commands_insn_len (struct gdbarch *gdbarch, CORE_ADDR addr)
+{
+  int isize = 0;
+  volatile struct gdb_exception ex;
+
+  TRY_CATCH (ex, RETURN_MASK_ERROR)
+    {
+      if (!gdbarch_fast_tracepoint_valid_at (gdbarch, addr, &isize, NULL))
+	isize = 0;
+    }
+  if (ex.reason < 0)
+    return 0;
+
+  return isize;
+}
+
 /* Insert a breakpoint.  On targets that have software breakpoint
    support, we ask the remote target to do the work; on targets
    which don't, we insert a traditional memory breakpoint.  */
@@ -8195,6 +8473,7 @@ remote_insert_breakpoint (struct gdbarch *gdbarch,
       char *p, *endbuf;
       int bpsize;
       struct condition_list *cond = NULL;
+      int fast_len = 0;
 
       /* Make sure the remote is pointing at the right process, if
 	 necessary.  */
@@ -8206,6 +8485,17 @@ remote_insert_breakpoint (struct gdbarch *gdbarch,
       /* Set the thread this applies to (which will be -1 if all threads). */
       set_breakpoint_thread (bp_tgt->ptid);
 
+      /* If the stub can, let it run the commands from a jump pad
+	 that replaces the instruction at the breakpoint address,
+	 rather than from a trap.  This reads memory, so do it before
+	 building the packet.  */
+      if (remote_can_run_breakpoint_commands ()
+	  && !VEC_empty (agent_expr_p, bp_tgt->tcommands)
+	  && (remote_protocol_packets[PACKET_FastBreakpointCommands].support
+	      == PACKET_ENABLE))
+	fast_len = remote_fast_commands_insn_len (gdbarch,
+						  bp_tgt->placed_address);
+
       /* Set the breakpoint */
       rs = get_remote_state ();
       p = rs->buf;
@@ -8222,11 +8512,25 @@ remote_insert_breakpoint (struct gdbarch *gdbarch,
 	remote_add_target_side_condition (gdbarch, bp_tgt, p, endbuf);
 
       if (remote_can_run_breakpoint_commands ())
-	remote_add_target_side_commands (gdbarch, bp_tgt, p);
+	{
+	  remote_add_target_side_commands (gdbarch, bp_tgt, p);
+
+	  if (fast_len > 0)
+	    xsnprintf (p + strlen (p), endbuf - p - strlen (p),
+		       ";fast:%x", fast_len);
+	}
 
       putpkt (rs->buf);
       getpkt (&rs->buf, &rs->buf_size, 0);
 
+      /* Installing the jump pad may need the original instruction
+	 relocated.  */
+      while (strncmp (rs->buf, "qRelocInsn:", strlen ("qRelocInsn:")) == 0)
+	{
+	  remote_relocate_insn_request (rs->buf, rs->buf_size);
+	  getpkt (&rs->buf, &rs->buf_size, 0);
+	}
+
       switch (packet_ok (rs->buf, &remote_protocol_packets[PACKET_Z0]))
 	{
 	case PACKET_ERROR:
@@ -9145,6 +9449,9 @@ remote_rcmd (char *command,
   if (!remote_desc)
     error (_("remote rcmd is only available after target open"));
 
+  /* The monitor command may change the inferior's memory.  */
+  clear_stop_memory ();
+
   /* Send a NULL command across as an empty command.  */
   if (command == NULL)
     command = "";
@@ -10867,6 +11174,9 @@ Too many sections for read-only sections definition packet."));
 static void
 remote_trace_start (void)
 {
+  /* Installing fast tracepoints writes to the inferior.  */
+  clear_stop_memory ();
+
   putpkt ("QTStart");
   remote_get_noisy_reply (&target_buf, &target_buf_size);
   if (*target_buf == '\0')
@@ -12012,6 +12322,24 @@ Specify a negative limit for unlimited."),
                                            length (in bytes) of a target
                                            hardware watchpoint is %s.  */
 			    &remote_set_cmdlist, &remote_show_cmdlist);
+  add_setshow_zuinteger_cmd ("stop-reply-stack-size", no_class,
+			     &remote_stop_reply_stack_size, _("\
+Set the number of stack bytes the target sends with each stop."), _("\
+Show the number of stack bytes the target sends with each stop."), _("\
+When the target supports it, this many bytes of memory at the stack\n\
+pointer are sent along with each stop reply, saving GDB the round trips\n\
+it would otherwise need to read them.  Zero turns this off."),
+			     NULL, NULL,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
+  add_setshow_zuinteger_cmd ("stop-reply-code-size", no_class,
+			     &remote_stop_reply_code_size, _("\
+Set the number of code bytes the target sends with each stop."), _("\
+Show the number of code bytes the target sends with each stop."), _("\
+When the target supports it, this many bytes of memory at the program\n\
+counter are sent along with each stop reply, saving GDB the round trips\n\
+it would otherwise need to read them.  Zero turns this off."),
+			     NULL, NULL,
+			     &remote_set_cmdlist, &remote_show_cmdlist);
   add_setshow_zinteger_cmd ("hardware-breakpoint-limit", no_class,
 			    &remote_hw_breakpoint_limit, _("\
 Set the maximum number of target hardware breakpoints."), _("\
@@ -12033,6 +12361,12 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
   add_packet_config_cmd (&remote_protocol_packets[PACKET_X],
 			 "X", "binary-download", 1);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_x],
+			 "x", "binary-upload", 0);
+
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_QExpediteMemory],
+			 "QExpediteMemory", "expedite-memory", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_vCont],
 			 "vCont", "verbose-resume", 0);
 
@@ -12174,6 +12508,10 @@ Show the maximum size of the address (in bits) in a memory packet."), NULL,
 			 "BreakpointCommands",
 			 "breakpoint-commands", 0);
 
+  add_packet_config_cmd (&remote_protocol_packets[PACKET_FastBreakpointCommands],
+			 "FastBreakpointCommands",
+			 "fast-breakpoint-commands", 0);
+
   add_packet_config_cmd (&remote_protocol_packets[PACKET_FastTracepoints],
 			 "FastTracepoints", "fast-tracepoints", 0);
 
@@ -44,6 +44,7 @@
 #include "completer.h"
 #include "ui-out.h"
 #include "readline/readline.h"
+#include "hashtab.h"
 
 #include "psymtab.h"
 
@@ -1154,6 +1155,103 @@ symtab_to_filename_for_display (struct symtab *symtab)
     internal_error (__FILE__, __LINE__, _("invalid filename_display_string"));
 }
 
+/* The line positions of a source file, remembered across
+   forget_cached_source_info so that a file that has not changed need
+   not be scanned again.  There is one entry per full name, for the
+   version of the file last scanned.  A file edited in place may keep
+   its size and its mtime in whole seconds, so the inode and both times
+   to the nanosecond, where known, identify the version too.  */
+
+struct source_lines_entry
+{
+  /* The full name of the file.  */
+  char *fullname;
+  /* The identity of the file when it was scanned.  */
+  LONGEST size;
+  LONGEST ino;
+  LONGEST mtime;
+  LONGEST mtime_nsec;
+  LONGEST ctime;
+  LONGEST ctime_nsec;
+  /* The number of lines, and their positions.  */
+  int nlines;
+  int *line_charpos;
+};
+
+/* A hash table of source_lines_entry objects.  */
+
+static htab_t source_lines_cache;
+
+/* A hash function for source_lines_entry.  */
+
+static hashval_t
+hash_source_lines_entry (const void *p)
+{
+  const struct source_lines_entry *entry = p;
+
+  return filename_hash (entry->fullname);
+}
+
+/* An equality function for source_lines_entry.  */
+
+static int
+eq_source_lines_entry (const void *a, const void *b)
+{
+  const struct source_lines_entry *ea = a;
+  const struct source_lines_entry *eb = b;
+
+  return filename_cmp (ea->fullname, eb->fullname) == 0;
+}
+
+/* Record in ENTRY the identity of the file described by ST.  */
+
+static void
+source_lines_entry_set_identity (struct source_lines_entry *entry,
+				 const struct stat *st)
+{
+  entry->size = st->st_size;
+  entry->ino = st->st_ino;
+  entry->mtime = st->st_mtime;
+  entry->ctime = st->st_ctime;
+#ifdef HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC
+  entry->mtime_nsec = st->st_mtim.tv_nsec;
+  entry->ctime_nsec = st->st_ctim.tv_nsec;
+#else
+  entry->mtime_nsec = 0;
+  entry->ctime_nsec = 0;
+#endif
+}
+
+/* Return non-zero if ENTRY was scanned from the version of the file
+   described by ST.  */
+
+static int
+source_lines_entry_matches (const struct source_lines_entry *entry,
+			    const struct stat *st)
+{
+  struct source_lines_entry id;
+
+  source_lines_entry_set_identity (&id, st);
+  return (entry->size == id.size
+	  && entry->ino == id.ino
+	  && entry->mtime == id.mtime
+	  && entry->mtime_nsec == id.mtime_nsec
+	  && entry->ctime == id.ctime
+	  && entry->ctime_nsec == id.ctime_nsec);
+}
+
+/* A deletion function for source_lines_entry.  */
+
+static void
+free_source_lines_entry (void *p)
+{
+  struct source_lines_entry *entry = p;
+
+  xfree (entry->fullname);
+  xfree (entry->line_charpos);
+  xfree (entry);
+}
+
 /* Create and initialize the table S->line_charpos that records
    the positions of the lines in the source file, which is assumed
    to be open on descriptor DESC.
@@ -1169,9 +1267,9 @@ find_source_lines (struct symtab *s, int desc)
   int *line_charpos;
   long mtime = 0;
   int size;
+  struct source_lines_entry search, *entry;
 
   gdb_assert (s);
-  line_charpos = (int *) xmalloc (lines_allocated * sizeof (int));
   if (fstat (desc, &st) < 0)
     perror_with_name (symtab_to_filename_for_display (s));
 
@@ -1183,6 +1281,28 @@ find_source_lines (struct symtab *s, int desc)
   if (mtime && mtime < st.st_mtime)
     warning (_("Source file is more recent than executable."));
 
+  if (s->fullname != NULL)
+    {
+      if (source_lines_cache == NULL)
+	source_lines_cache = htab_create_alloc (10, hash_source_lines_entry,
+					       eq_source_lines_entry,
+					       free_source_lines_entry,
+					       xcalloc, xfree);
+
+      search.fullname = s->fullname;
+      entry = htab_find (source_lines_cache, &search);
+      if (entry != NULL && source_lines_entry_matches (entry, &st))
+	{
+	  s->nlines = entry->nlines;
+	  s->line_charpos = xmalloc (entry->nlines * sizeof (int));
+	  memcpy (s->line_charpos, entry->line_charpos,
+		  entry->nlines * sizeof (int));
+	  return;
+	}
+    }
+
+  line_charpos = (int *) xmalloc (lines_allocated * sizeof (int));
+
   {
     struct cleanup *old_cleanups;
 
@@ -1203,21 +1323,18 @@ find_source_lines (struct symtab *s, int desc)
     p = data;
     line_charpos[0] = 0;
     nlines = 1;
-    while (p != end)
+    while ((p = memchr (p, '\n', end - p)) != NULL
+	   /* A newline at the end does not start a new line.  */
+	   && ++p != end)
       {
-	if (*p++ == '\n'
-	/* A newline at the end does not start a new line.  */
-	    && p != end)
+	if (nlines == lines_allocated)
 	  {
-	    if (nlines == lines_allocated)
-	      {
-		lines_allocated *= 2;
-		line_charpos =
-		  (int *) xrealloc ((char *) line_charpos,
-				    sizeof (int) * lines_allocated);
-	      }
-	    line_charpos[nlines++] = p - data;
+	    lines_allocated *= 2;
+	    line_charpos =
+	      (int *) xrealloc ((char *) line_charpos,
+				sizeof (int) * lines_allocated);
 	  }
+	line_charpos[nlines++] = p - data;
       }
     do_cleanups (old_cleanups);
   }
@@ -1226,6 +1343,23 @@ find_source_lines (struct symtab *s, int desc)
   s->line_charpos =
     (int *) xrealloc ((char *) line_charpos, nlines * sizeof (int));
 
+  if (s->fullname != NULL)
+    {
+      void **slot;
+
+      entry = XNEW (struct source_lines_entry);
+      entry->fullname = xstrdup (s->fullname);
+      source_lines_entry_set_identity (entry, &st);
+      entry->nlines = nlines;
+      entry->line_charpos = xmalloc (nlines * sizeof (int));
+      memcpy (entry->line_charpos, s->line_charpos, nlines * sizeof (int));
+
+      /* Replace any entry for an older version of the file.  */
+      slot = htab_find_slot (source_lines_cache, entry, INSERT);
+      if (*slot != NULL)
+	free_source_lines_entry (*slot);
+      *slot = entry;
+    }
 }
 
 
@@ -4583,6 +4583,42 @@ cleanup_undefined_stabs_types (struct objfile *objfile)
   cleanup_undefined_types_noname (objfile);
 }
 
+/* Return the minimal symbol of OBJFILE called NAME that the debugging
+   symbols of that name should take their address from: the first one
+   in address order that is not static.  Return NULL if there is
+   none.  */
+
+static struct minimal_symbol *
+find_global_minsym (struct objfile *objfile, const char *name)
+{
+  struct minimal_symbol *msymbol, *found = NULL;
+  unsigned int hash = msymbol_hash (name) % MINIMAL_SYMBOL_HASH_SIZE;
+
+  for (msymbol = objfile->msymbol_hash[hash];
+       msymbol != NULL;
+       msymbol = msymbol->hash_next)
+    {
+      /* Skip static symbols.  */
+      switch (MSYMBOL_TYPE (msymbol))
+	{
+	case mst_file_text:
+	case mst_file_data:
+	case mst_file_bss:
+	  continue;
+	default:
+	  break;
+	}
+
+      /* The table of minimal symbols is sorted by address; prefer
+	 the match that comes first in it.  */
+      if ((found == NULL || msymbol < found)
+	  && strcmp (SYMBOL_LINKAGE_NAME (msymbol), name) == 0)
+	found = msymbol;
+    }
+
+  return found;
+}
+
 /* Scan through all of the global symbols defined in the object file,
    assigning values to the debugging symbols that need to be assigned
    to.  Get these symbols from the minimal symbol table.  */
@@ -4607,42 +4643,20 @@ scan_file_globals (struct objfile *objfile)
 
   while (1)
     {
-      /* Avoid expensive loop through all minimal symbols if there are
-         no unresolved symbols.  */
+      /* Look each unresolved symbol up by name, rather than walking
+	 all of the minimal symbols for each object file's few
+	 unresolved symbols.  */
       for (hash = 0; hash < HASHSIZE; hash++)
 	{
-	  if (global_sym_chain[hash])
-	    break;
-	}
-      if (hash >= HASHSIZE)
-	return;
-
-      ALL_OBJFILE_MSYMBOLS (resolve_objfile, msymbol)
-	{
-	  QUIT;
-
-	  /* Skip static symbols.  */
-	  switch (MSYMBOL_TYPE (msymbol))
-	    {
-	    case mst_file_text:
-	    case mst_file_data:
-	    case mst_file_bss:
-	      continue;
-	    default:
-	      break;
-	    }
-
 	  prev = NULL;
 
-	  /* Get the hash index and check all the symbols
-	     under that hash index.  */
-
-	  hash = hashname (SYMBOL_LINKAGE_NAME (msymbol));
-
 	  for (sym = global_sym_chain[hash]; sym;)
 	    {
-	      if (strcmp (SYMBOL_LINKAGE_NAME (msymbol),
-			  SYMBOL_LINKAGE_NAME (sym)) == 0)
+	      QUIT;
+
+	      msymbol = find_global_minsym (resolve_objfile,
+					    SYMBOL_LINKAGE_NAME (sym));
+	      if (msymbol != NULL)
 		{
 		  /* Splice this symbol out of the hash chain and
 		     assign the value we have to it.  */
@@ -4658,20 +4672,17 @@ scan_file_globals (struct objfile *objfile)
 		  /* Check to see whether we need to fix up a common block.  */
 		  /* Note: this code might be executed several times for
 		     the same symbol if there are multiple references.  */
-		  if (sym)
+		  if (SYMBOL_CLASS (sym) == LOC_BLOCK)
+		    {
+		      fix_common_block (sym,
+					SYMBOL_VALUE_ADDRESS (msymbol));
+		    }
+		  else
 		    {
-		      if (SYMBOL_CLASS (sym) == LOC_BLOCK)
-			{
-			  fix_common_block (sym,
-					    SYMBOL_VALUE_ADDRESS (msymbol));
-			}
-		      else
-			{
-			  SYMBOL_VALUE_ADDRESS (sym)
-			    = SYMBOL_VALUE_ADDRESS (msymbol);
-			}
-		      SYMBOL_SECTION (sym) = SYMBOL_SECTION (msymbol);
+		      SYMBOL_VALUE_ADDRESS (sym)
+			= SYMBOL_VALUE_ADDRESS (msymbol);
 		    }
+		  SYMBOL_SECTION (sym) = SYMBOL_SECTION (msymbol);
 
 		  if (prev)
 		    {
@@ -2479,11 +2479,6 @@ reread_symbols (void)
 	  /* Free the obstacks for non-reusable objfiles.  */
 	  psymbol_bcache_free (objfile->psymbol_cache);
 	  objfile->psymbol_cache = psymbol_bcache_init ();
-	  if (objfile->demangled_names_hash != NULL)
-	    {
-	      htab_delete (objfile->demangled_names_hash);
-	      objfile->demangled_names_hash = NULL;
-	    }
 	  obstack_free (&objfile->objfile_obstack, 0);
 	  objfile->sections = NULL;
 	  objfile->symtabs = NULL;
@@ -2935,6 +2930,9 @@ overlay_invalidate_all (void)
   ALL_OBJSECTIONS (objfile, sect)
     if (section_is_overlay (sect))
       sect->ovly_mapped = -1;
+
+  /* Parsed expressions hold the overlaid addresses of symbols.  */
+  clear_expression_cache ();
 }
 
 /* Function: section_is_mapped (SECTION)
@@ -3224,6 +3222,7 @@ map_overlay_command (char *args, int from_tty)
 					       sec2->the_bfd_section));
 	  sec2->ovly_mapped = 0;	/* sec2 overlaps sec: unmap sec2.  */
 	}
+      clear_expression_cache ();
       return;
     }
   error (_("No overlay section called %s"), args);
@@ -3254,6 +3253,7 @@ unmap_overlay_command (char *args, int from_tty)
       if (!sec->ovly_mapped)
 	error (_("Section %s is not mapped"), args);
       sec->ovly_mapped = 0;
+      clear_expression_cache ();
       return;
     }
   error (_("No overlay section called %s"), args);
@@ -3267,6 +3267,7 @@ static void
 overlay_auto_command (char *args, int from_tty)
 {
   overlay_debugging = ovly_auto;
+  clear_expression_cache ();
   enable_overlay_breakpoints ();
   if (info_verbose)
     printf_unfiltered (_("Automatic overlay debugging enabled."));
@@ -3280,6 +3281,7 @@ static void
 overlay_manual_command (char *args, int from_tty)
 {
   overlay_debugging = ovly_on;
+  clear_expression_cache ();
   disable_overlay_breakpoints ();
   if (info_verbose)
     printf_unfiltered (_("Overlay debugging enabled."));
@@ -3293,6 +3295,7 @@ static void
 overlay_off_command (char *args, int from_tty)
 {
   overlay_debugging = ovly_off;
+  clear_expression_cache ();
   disable_overlay_breakpoints ();
   if (info_verbose)
     printf_unfiltered (_("Overlay debugging disabled."));
@@ -3307,6 +3310,7 @@ overlay_load_command (char *args, int from_tty)
     gdbarch_overlay_update (gdbarch, NULL);
   else
     error (_("This target does not know how to read its overlay state."));
+  clear_expression_cache ();
 }
 
 /* Function: overlay_command
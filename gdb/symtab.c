@@ -525,6 +525,13 @@ symbol_set_language (struct general_symbol_info *gsymbol,
 struct demangled_name_entry
 {
   const char *mangled;
+
+  /* The language the demangler found for MANGLED, or language_auto if
+     it could not be demangled.  A symbol of unknown language that
+     finds this entry takes it over, just as it would have done had
+     the name been demangled for it.  */
+  ENUM_BITFIELD(language) language : 8;
+
   char demangled[1];
 };
 
@@ -554,18 +561,25 @@ eq_demangled_name_entry (const void *a, const void *b)
    name.  The entry is hashed via just the mangled name.  */
 
 static void
-create_demangled_names_hash (struct objfile *objfile)
+create_demangled_names_hash (struct objfile *objfile, size_t size)
 {
-  /* Choose 256 as the starting size of the hash table, somewhat arbitrarily.
-     The hash table code will round this up to the next prime number.
-     Choosing a much larger table size wastes memory, and saves only about
-     1% in symbol reading.  */
-
-  objfile->demangled_names_hash = htab_create_alloc
-    (256, hash_demangled_name_entry, eq_demangled_name_entry,
+  objfile->per_bfd->demangled_names_hash = htab_create_alloc
+    (size, hash_demangled_name_entry, eq_demangled_name_entry,
      NULL, xcalloc, xfree);
 }
 
+/* See symtab.h.  */
+
+void
+reserve_demangled_names (struct objfile *objfile, size_t count)
+{
+  /* The table is only sized when it is created; an existing table
+     just keeps growing as needed.  A hash table grows once it is
+     three quarters full, so leave room for that.  */
+  if (objfile->per_bfd->demangled_names_hash == NULL && count > 256)
+    create_demangled_names_hash (objfile, count + count / 3 + 1);
+}
+
 /* Try to determine the demangled name for a symbol, based on the
    language of that symbol.  If the language is set to language_auto,
    it will attempt to find any demangling algorithm that works and
@@ -653,11 +667,12 @@ symbol_find_demangled_name (struct general_symbol_info *gsymbol,
    objfile's obstack; but if COPY_NAME is 0 and if NAME is
    NUL-terminated, then this function assumes that NAME is already
    correctly saved (either permanently or with a lifetime tied to the
-   objfile), and it will not be copied.
+   objfile), and it will not be copied if OBJFILE has no BFD.
 
-   The hash table corresponding to OBJFILE is used, and the memory
-   comes from that objfile's objfile_obstack.  LINKAGE_NAME is copied,
-   so the pointer can be discarded after calling this function.  */
+   The hash table shared by the objfiles using OBJFILE's BFD is used,
+   and the memory comes from its per-BFD obstack.  LINKAGE_NAME is
+   copied, so the pointer can be discarded after calling this
+   function.  */
 
 /* We have to be careful when dealing with Java names: when we run
    into a Java minimal symbol, we don't know it's a Java symbol, so it
@@ -718,8 +733,13 @@ symbol_set_names (struct general_symbol_info *gsymbol,
       return;
     }
 
-  if (objfile->demangled_names_hash == NULL)
-    create_demangled_names_hash (objfile);
+  /* Choose 256 as the starting size of the hash table, somewhat
+     arbitrarily.  The hash table code will round this up to the next
+     prime number.  Choosing a much larger table size wastes memory,
+     and saves only about 1% in symbol reading; readers that know how
+     many names are coming can use reserve_demangled_names instead.  */
+  if (objfile->per_bfd->demangled_names_hash == NULL)
+    create_demangled_names_hash (objfile, 256);
 
   /* The stabs reader generally provides names that are not
      NUL-terminated; most of the other readers don't do this, so we
@@ -758,7 +778,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 
   entry.mangled = lookup_name;
   slot = ((struct demangled_name_entry **)
-	  htab_find_slot (objfile->demangled_names_hash,
+	  htab_find_slot (objfile->per_bfd->demangled_names_hash,
 			  &entry, INSERT));
 
   /* If this name is not in the hash table, add it.  */
@@ -780,10 +800,14 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	 
 	 It turns out that it is actually important to still save such
 	 an entry in the hash table, because storing this name gives
-	 us better bcache hit rates for partial symbols.  */
-      if (!copy_name && lookup_name == linkage_name)
+	 us better bcache hit rates for partial symbols.
+
+	 The table is shared with the other objfiles using the same BFD,
+	 which may outlive this one, so the name must be copied unless
+	 OBJFILE has no BFD, and hence a table of its own.  */
+      if (!copy_name && lookup_name == linkage_name && objfile->obfd == NULL)
 	{
-	  *slot = obstack_alloc (&objfile->objfile_obstack,
+	  *slot = obstack_alloc (&objfile->per_bfd->storage_obstack,
 				 offsetof (struct demangled_name_entry,
 					   demangled)
 				 + demangled_len + 1);
@@ -796,7 +820,7 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 	  /* If we must copy the mangled name, put it directly after
 	     the demangled name so we can have a single
 	     allocation.  */
-	  *slot = obstack_alloc (&objfile->objfile_obstack,
+	  *slot = obstack_alloc (&objfile->per_bfd->storage_obstack,
 				 offsetof (struct demangled_name_entry,
 					   demangled)
 				 + lookup_len + demangled_len + 2);
@@ -807,12 +831,20 @@ symbol_set_names (struct general_symbol_info *gsymbol,
 
       if (demangled_name != NULL)
 	{
+	  (*slot)->language = gsymbol->language;
 	  strcpy ((*slot)->demangled, demangled_name);
 	  xfree (demangled_name);
 	}
       else
-	(*slot)->demangled[0] = '\0';
+	{
+	  (*slot)->language = language_auto;
+	  (*slot)->demangled[0] = '\0';
+	}
     }
+  else if ((gsymbol->language == language_auto
+	    || gsymbol->language == language_unknown)
+	   && (*slot)->language != language_auto)
+    gsymbol->language = (*slot)->language;
 
   gsymbol->name = (*slot)->mangled + lookup_len - len;
   if ((*slot)->demangled[0] != '\0')
@@ -224,6 +224,11 @@ extern void symbol_set_names (struct general_symbol_info *symbol,
 			      const char *linkage_name, int len, int copy_name,
 			      struct objfile *objfile);
 
+/* Tell OBJFILE that about COUNT names are about to be passed to
+   symbol_set_names, so that the table of demangled names can be
+   allocated at that size rather than grown repeatedly.  */
+extern void reserve_demangled_names (struct objfile *objfile, size_t count);
+
 /* Now come lots of name accessor macros.  Short version as to when to
    use which: Use SYMBOL_NATURAL_NAME to refer to the name of the
    symbol in the original source code.  Use SYMBOL_LINKAGE_NAME if you
@@ -0,0 +1,55 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+
+#define NUM_THREADS 8
+#define NUM_ITERS 500
+
+volatile int counter;
+
+void
+hot (int i)
+{
+  __sync_fetch_and_add (&counter, i);
+}
+
+static void *
+thread_function (void *arg)
+{
+  int i;
+
+  for (i = 0; i < NUM_ITERS; i++)
+    hot (i);
+
+  return NULL;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_join (threads[i], NULL);
+
+  return counter != NUM_THREADS * (NUM_ITERS * (NUM_ITERS - 1) / 2); /* set break here */
+}
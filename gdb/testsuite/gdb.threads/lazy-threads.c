@@ -0,0 +1,65 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/* This program is intended to be started outside of gdb, and then
+   attached to.  */
+
+#define NUM_THREADS 4
+
+/* Each thread stores its LWP number here.  */
+__thread long lwp_tls;
+
+static pthread_barrier_t barrier;
+
+static void *
+thread_function (void *arg)
+{
+  lwp_tls = syscall (SYS_gettid);
+  pthread_barrier_wait (&barrier);
+
+  while (1)
+    sleep (1);
+
+  return NULL;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NUM_THREADS];
+  int i;
+
+  /* Don't run forever if the test fails to kill us.  */
+  alarm (300);
+
+  lwp_tls = syscall (SYS_gettid);
+  pthread_barrier_init (&barrier, NULL, NUM_THREADS + 1);
+
+  for (i = 0; i < NUM_THREADS; i++)
+    pthread_create (&threads[i], NULL, thread_function, NULL);
+
+  pthread_barrier_wait (&barrier);
+
+  while (1)
+    sleep (1);
+
+  return 0;
+}
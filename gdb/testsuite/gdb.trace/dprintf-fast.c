@@ -0,0 +1,71 @@
+/* This testcase is part of GDB, the GNU debugger.
+
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <string.h>
+
+#define ROUNDS 4
+
+/* The length of an x86 jump to a jump pad.  */
+#define JUMP_SIZE 5
+
+volatile int hits;
+volatile int total;
+
+/* Set by the test to the address of the dprintf.  */
+unsigned char *volatile dprintf_site;
+
+/* The code at DPRINTF_SITE, as the program sees it while running.  */
+unsigned char site_code[JUMP_SIZE];
+
+static void
+hot (int i)
+{
+  total += i; /* dprintf here */
+  hits++;
+  if (dprintf_site != NULL)
+    memcpy (site_code, dprintf_site, JUMP_SIZE);
+}
+
+static void
+mark (void)
+{
+}
+
+static void
+end (void)
+{
+}
+
+int
+main (void)
+{
+  int round, i;
+
+  for (round = 0; round < ROUNDS; round++)
+    {
+      for (i = 0; i < 100; i++)
+	hot (round * 100 + i);
+
+      mark ();
+    }
+
+  for (i = 0; i < 100; i++)
+    hot (i);
+
+  end ();
+  return 0;
+}
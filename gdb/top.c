@@ -65,6 +65,7 @@
 #include "ui-out.h"
 #include "cli-out.h"
 #include "tracepoint.h"
+#include "auto-load.h"
 
 extern void initialize_all_files (void);
 
@@ -349,6 +350,10 @@ prepare_execute_command (void)
   if (non_stop)
     target_dcache_invalidate ();
 
+  /* Files may have been created since the last command; look for
+     auto-load scripts afresh.  */
+  auto_load_invalidate_caches ();
+
   return cleanup;
 }
 
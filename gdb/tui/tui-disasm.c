@@ -37,6 +37,8 @@
 #include "tui/tui-file.h"
 #include "tui/tui-disasm.h"
 #include "progspace.h"
+#include "observer.h"
+#include "hashtab.h"
 
 #include "gdb_curses.h"
 
@@ -47,6 +49,68 @@ struct tui_asm_line
   char *insn;
 };
 
+/* A disassembled instruction.  Finding the start of the window
+   disassembles the same instructions several times, and so does
+   scrolling, so instructions are cached by program space and address
+   until the inferior resumes, its memory or symbols change, or
+   another traceframe is selected.  */
+
+struct tui_asm_cache_entry
+{
+  struct program_space *pspace;
+  struct gdbarch *gdbarch;
+  CORE_ADDR addr;
+  /* The address of the next instruction.  */
+  CORE_ADDR next;
+  char *addr_string;
+  char *insn;
+};
+
+/* A hash table of tui_asm_cache_entry objects, or NULL if empty.  */
+
+static htab_t tui_asm_cache;
+
+static hashval_t
+hash_tui_asm_cache_entry (const void *p)
+{
+  const struct tui_asm_cache_entry *entry = p;
+
+  return (htab_hash_pointer (entry->pspace)
+	  ^ htab_hash_pointer (entry->gdbarch) ^ (hashval_t) entry->addr);
+}
+
+static int
+eq_tui_asm_cache_entry (const void *a, const void *b)
+{
+  const struct tui_asm_cache_entry *ea = a;
+  const struct tui_asm_cache_entry *eb = b;
+
+  return (ea->pspace == eb->pspace && ea->gdbarch == eb->gdbarch
+	  && ea->addr == eb->addr);
+}
+
+static void
+free_tui_asm_cache_entry (void *p)
+{
+  struct tui_asm_cache_entry *entry = p;
+
+  xfree (entry->addr_string);
+  xfree (entry->insn);
+  xfree (entry);
+}
+
+/* Forget all cached instructions.  */
+
+static void
+tui_clear_asm_cache (void)
+{
+  if (tui_asm_cache != NULL)
+    {
+      htab_delete (tui_asm_cache);
+      tui_asm_cache = NULL;
+    }
+}
+
 /* Function to set the disassembly window's content.
    Disassemble count lines starting at pc.
    Return address of the count'th instruction after pc.  */
@@ -54,33 +118,69 @@ static CORE_ADDR
 tui_disassemble (struct gdbarch *gdbarch, struct tui_asm_line *asm_lines,
 		 CORE_ADDR pc, int count)
 {
-  struct ui_file *gdb_dis_out;
+  struct ui_file *gdb_dis_out = NULL;
+  struct cleanup *cleanups = make_cleanup (null_cleanup, NULL);
 
-  /* Now init the ui_file structure.  */
-  gdb_dis_out = tui_sfileopen (256);
+  if (tui_asm_cache == NULL)
+    tui_asm_cache = htab_create_alloc (64, hash_tui_asm_cache_entry,
+				       eq_tui_asm_cache_entry,
+				       free_tui_asm_cache_entry,
+				       xcalloc, xfree);
 
   /* Now construct each line.  */
   for (; count > 0; count--, asm_lines++)
     {
+      struct tui_asm_cache_entry search, *entry;
+      void **slot;
+      int len;
+
       if (asm_lines->addr_string)
         xfree (asm_lines->addr_string);
       if (asm_lines->insn)
         xfree (asm_lines->insn);
-      
-      print_address (gdbarch, pc, gdb_dis_out);
-      asm_lines->addr = pc;
-      asm_lines->addr_string = xstrdup (tui_file_get_strbuf (gdb_dis_out));
-
-      ui_file_rewind (gdb_dis_out);
 
-      pc = pc + gdb_print_insn (gdbarch, pc, gdb_dis_out, NULL);
-
-      asm_lines->insn = xstrdup (tui_file_get_strbuf (gdb_dis_out));
+      search.pspace = current_program_space;
+      search.gdbarch = gdbarch;
+      search.addr = pc;
+      entry = htab_find (tui_asm_cache, &search);
+      if (entry == NULL)
+	{
+	  if (gdb_dis_out == NULL)
+	    {
+	      /* Now init the ui_file structure.  */
+	      gdb_dis_out = tui_sfileopen (256);
+	      make_cleanup_ui_file_delete (gdb_dis_out);
+	    }
+
+	  /* Disassemble first: this throws if PC is not readable, and
+	     nothing has been allocated yet.  */
+	  len = gdb_print_insn (gdbarch, pc, gdb_dis_out, NULL);
+
+	  entry = XNEW (struct tui_asm_cache_entry);
+	  entry->pspace = current_program_space;
+	  entry->gdbarch = gdbarch;
+	  entry->addr = pc;
+	  entry->next = pc + len;
+	  entry->insn = xstrdup (tui_file_get_strbuf (gdb_dis_out));
+
+	  ui_file_rewind (gdb_dis_out);
+
+	  print_address (gdbarch, pc, gdb_dis_out);
+	  entry->addr_string = xstrdup (tui_file_get_strbuf (gdb_dis_out));
+
+	  /* Reset the buffer to empty.  */
+	  ui_file_rewind (gdb_dis_out);
+
+	  slot = htab_find_slot (tui_asm_cache, entry, INSERT);
+	  *slot = entry;
+	}
 
-      /* Reset the buffer to empty.  */
-      ui_file_rewind (gdb_dis_out);
+      asm_lines->addr = pc;
+      asm_lines->addr_string = xstrdup (entry->addr_string);
+      asm_lines->insn = xstrdup (entry->insn);
+      pc = entry->next;
     }
-  ui_file_delete (gdb_dis_out);
+  do_cleanups (cleanups);
   return pc;
 }
 
@@ -408,3 +508,72 @@ tui_vertical_disassem_scroll (enum tui_scroll_direction scroll_direction,
 				      NULL, val, FALSE);
     }
 }
+
+/* Observers that invalidate the cache of disassembled instructions.
+   Code and symbols may change whenever the inferior runs.  */
+
+static void
+tui_asm_cache_target_resumed (ptid_t ptid)
+{
+  tui_clear_asm_cache ();
+}
+
+static void
+tui_asm_cache_memory_changed (struct inferior *inferior, CORE_ADDR addr,
+			      ssize_t len, const bfd_byte *data)
+{
+  tui_clear_asm_cache ();
+}
+
+static void
+tui_asm_cache_new_objfile (struct objfile *objfile)
+{
+  tui_clear_asm_cache ();
+}
+
+static void
+tui_asm_cache_inferior_created (struct target_ops *ops, int from_tty)
+{
+  tui_clear_asm_cache ();
+}
+
+static void
+tui_asm_cache_inferior_changed (struct inferior *inf)
+{
+  tui_clear_asm_cache ();
+}
+
+/* A traceframe shows the memory collected at that point, not the
+   live memory.  */
+
+static void
+tui_asm_cache_traceframe_changed (int tfnum, int tpnum)
+{
+  tui_clear_asm_cache ();
+}
+
+/* Settings such as "set disassembly-flavor" change how instructions
+   are printed.  */
+
+static void
+tui_asm_cache_command_param_changed (const char *param, const char *value)
+{
+  tui_clear_asm_cache ();
+}
+
+/* Provide a prototype to silence -Wmissing-prototypes.  */
+extern initialize_file_ftype _initialize_tui_disasm;
+
+void
+_initialize_tui_disasm (void)
+{
+  observer_attach_target_resumed (tui_asm_cache_target_resumed);
+  observer_attach_memory_changed (tui_asm_cache_memory_changed);
+  observer_attach_new_objfile (tui_asm_cache_new_objfile);
+  observer_attach_inferior_created (tui_asm_cache_inferior_created);
+  observer_attach_inferior_appeared (tui_asm_cache_inferior_changed);
+  observer_attach_inferior_exit (tui_asm_cache_inferior_changed);
+  observer_attach_traceframe_changed (tui_asm_cache_traceframe_changed);
+  observer_attach_command_param_changed
+    (tui_asm_cache_command_param_changed);
+}
@@ -379,20 +379,6 @@ tui_show_frame_info (struct frame_info *fi)
 	      if (start_line <= 0)
 		start_line = 1;
 	    }
-	  else
-	    {
-	      if (find_pc_partial_function (get_frame_pc (fi),
-					    (const char **) NULL,
-					    &low, (CORE_ADDR) 0) == 0)
-		{
-		  /* There is no symbol available for current PC.  There is no
-		     safe way how to "disassemble backwards".  */
-		  low = get_frame_pc (fi);
-		}
-	      else
-		low = tui_get_low_disassembly_address (get_frame_arch (fi),
-						       low, get_frame_pc (fi));
-	    }
 
 	  if (win_info == TUI_SRC_WIN)
 	    {
@@ -418,11 +404,29 @@ tui_show_frame_info (struct frame_info *fi)
 		  struct tui_line_or_address a;
 
 		  a.loa = LOA_ADDRESS;
-		  a.u.addr = low;
 		  if (!tui_addr_is_displayed (item->locator.addr,
 					      win_info, TRUE))
-		    tui_update_source_window (win_info, get_frame_arch (fi),
-					      sal.symtab, a, TRUE);
+		    {
+		      /* Only look for the start of the window, which means
+			 disassembling backwards from the PC, if the PC is
+			 not already displayed.  */
+		      if (find_pc_partial_function (get_frame_pc (fi),
+						    (const char **) NULL,
+						    &low, (CORE_ADDR) 0) == 0)
+			{
+			  /* There is no symbol available for current PC.
+			     There is no safe way how to "disassemble
+			     backwards".  */
+			  low = get_frame_pc (fi);
+			}
+		      else
+			low = tui_get_low_disassembly_address
+			  (get_frame_arch (fi), low, get_frame_pc (fi));
+
+		      a.u.addr = low;
+		      tui_update_source_window (win_info, get_frame_arch (fi),
+						sal.symtab, a, TRUE);
+		    }
 		  else
 		    {
 		      a.u.addr = item->locator.addr;
@@ -566,8 +566,9 @@ tui_show_exec_info_content (struct tui_win_info *win_info)
     = win_info->detail.source_info.execution_info;
   int cur_line;
 
+  /* Refresh only once the new content is drawn, so that curses sends
+     just the markers that changed rather than a blank column first.  */
   werase (exec_info->handle);
-  tui_refresh_win (exec_info);
   for (cur_line = 1; (cur_line <= exec_info->content_size); cur_line++)
     mvwaddstr (exec_info->handle,
 	       cur_line,
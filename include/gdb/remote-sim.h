@@ -203,6 +203,19 @@ int sim_fetch_register (SIM_DESC sd, int regno, unsigned char *buf, int length);
 int sim_store_register (SIM_DESC sd, int regno, unsigned char *buf, int length);
 
 
+/* Fetch NR_REGS registers in one call.  For each I, register
+   REGNOS[I] is fetched into the LENGTHS[I] byte buffer BUFS[I] and
+   the value sim_fetch_register would have returned for it is stored
+   in RESULTS[I].
+
+   A generic implementation that calls sim_fetch_register for each
+   register is provided in common/bulk.c.  */
+
+void sim_fetch_registers (SIM_DESC sd, int nr_regs, const int *regnos,
+			  unsigned char **bufs, const int *lengths,
+			  int *results);
+
+
 /* Print whatever statistics the simulator has collected.
 
    VERBOSE is currently unused and must always be zero.  */
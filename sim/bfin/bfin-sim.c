@@ -1914,6 +1914,7 @@ decode_ProgCtrl_0 (SIM_CPU *cpu, bu16 iw0, bu32 pc)
       SET_PCREG (newpc);
       BFIN_CPU_STATE.did_jump = true;
       PROFILE_BRANCH_TAKEN (cpu);
+      PROFILE_CALL (cpu, pc, newpc);
       CYCLE_DELAY = 5;
     }
   else if (prgfunc == 7 && poprnd < 8)
@@ -1929,6 +1930,7 @@ decode_ProgCtrl_0 (SIM_CPU *cpu, bu16 iw0, bu32 pc)
       SET_PCREG (newpc);
       BFIN_CPU_STATE.did_jump = true;
       PROFILE_BRANCH_TAKEN (cpu);
+      PROFILE_CALL (cpu, pc, newpc);
       CYCLE_DELAY = 5;
     }
   else if (prgfunc == 8 && poprnd < 8)
@@ -3621,6 +3623,7 @@ decode_CALLa_0 (SIM_CPU *cpu, bu16 iw0, bu16 iw1, bu32 pc)
     {
       TRACE_BRANCH (cpu, pc, newpc, -1, "CALL");
       SET_RETSREG (hwloop_get_next_pc (cpu, pc, 4));
+      PROFILE_CALL (cpu, pc, newpc);
     }
   else
     TRACE_BRANCH (cpu, pc, newpc, -1, "JUMP.L");
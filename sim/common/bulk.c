@@ -0,0 +1,40 @@
+/* Bulk register access for the remote-sim interface.
+   Copyright 2013 Free Software Foundation, Inc.
+
+   This file is part of GDB.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Generic implementations of the batched entry points, in terms of
+   the single register ones.  Every simulator gets these, so GDB can
+   fill a whole regcache with a single call across the simulator
+   interface.  */
+
+#ifdef HAVE_CONFIG_H
+#include "cconfig.h"
+#endif
+#include "config.h"
+#include "ansidecl.h"
+#include "gdb/callback.h"
+#include "gdb/remote-sim.h"
+
+void
+sim_fetch_registers (SIM_DESC sd, int nr_regs, const int *regnos,
+		     unsigned char **bufs, const int *lengths, int *results)
+{
+  int i;
+
+  for (i = 0; i < nr_regs; i++)
+    results[i] = sim_fetch_register (sd, regnos[i], bufs[i], lengths[i]);
+}
@@ -77,10 +77,19 @@ sim_core_uninstall (SIM_DESC sd)
 	SIM_ASSERT (tbd->buffer != NULL);
 	free (tbd->free_buffer);
       }
+      if (tbd->watched != NULL)
+	free (tbd->watched);
       free (tbd);
     }
     core->common.map[map].first = NULL;
   }
+  /* and any memory watchpoints */
+  while (core->watchpoints != NULL)
+    {
+      sim_core_watch *dead = core->watchpoints;
+      core->watchpoints = dead->next;
+      free (dead);
+    }
 }
 #endif
 
@@ -269,6 +278,51 @@ sim_core_map_attach (SIM_DESC sd,
 #endif
 
 
+/* Recompute the watched page flags of every mapping in MAP from the
+   list of memory watchpoints.  */
+
+#if EXTERN_SIM_CORE_P
+static void
+sim_core_map_update_watched (SIM_DESC sd,
+			     unsigned map)
+{
+  sim_core *core = STATE_CORE (sd);
+  sim_core_mapping *mapping;
+  for (mapping = core->common.map[map].first;
+       mapping != NULL;
+       mapping = mapping->next)
+    {
+      sim_core_watch *watch;
+      if (mapping->watched != NULL)
+	{
+	  free (mapping->watched);
+	  mapping->watched = NULL;
+	}
+      for (watch = core->watchpoints; watch != NULL; watch = watch->next)
+	{
+	  address_word lo;
+	  address_word hi;
+	  if (watch->map != map
+	      || watch->base > mapping->bound
+	      || watch->bound < mapping->base)
+	    continue;
+	  if (mapping->watched == NULL)
+	    mapping->watched =
+	      NZALLOC (unsigned char,
+		       ((mapping->nr_bytes - 1) >> SIM_CORE_WATCH_PAGE_SHIFT) + 1);
+	  lo = (watch->base > mapping->base ? watch->base : mapping->base);
+	  hi = (watch->bound < mapping->bound ? watch->bound : mapping->bound);
+	  for (lo = (lo - mapping->base) >> SIM_CORE_WATCH_PAGE_SHIFT,
+		 hi = (hi - mapping->base) >> SIM_CORE_WATCH_PAGE_SHIFT;
+	       lo <= hi;
+	       lo++)
+	    mapping->watched[lo] = 1;
+	}
+    }
+}
+#endif
+
+
 /* Attach memory or a memory mapped device to the simulator.
    See sim-core.h for a full description.  */
 
@@ -385,6 +439,8 @@ sim_core_attach (SIM_DESC sd,
 	  sim_core_map_attach (sd, &memory->common.map[map],
 			       level, space, addr, nr_bytes, modulo,
 			       client, buffer, free_buffer);
+	  if (memory->watchpoints != NULL)
+	    sim_core_map_update_watched (sd, map);
 	  free_buffer = NULL;
 	}
     }
@@ -425,6 +481,8 @@ sim_core_map_detach (SIM_DESC sd,
 	  (*entry) = dead->next;
 	  if (dead->free_buffer != NULL)
 	    free (dead->free_buffer);
+	  if (dead->watched != NULL)
+	    free (dead->watched);
 	  free (dead);
 	  return;
 	}
@@ -461,6 +519,79 @@ sim_core_detach (SIM_DESC sd,
 #endif
 
 
+#if EXTERN_SIM_CORE_P
+sim_core_watch *
+sim_core_watch_insert (SIM_DESC sd,
+		       unsigned map,
+		       address_word base,
+		       address_word bound,
+		       sim_core_watch_handler *handler,
+		       void *data)
+{
+  sim_core *core = STATE_CORE (sd);
+  sim_core_watch *watch = ZALLOC (sim_core_watch);
+  SIM_ASSERT (map < nr_maps);
+  SIM_ASSERT (base <= bound);
+  watch->map = map;
+  watch->base = base;
+  watch->bound = bound;
+  watch->handler = handler;
+  watch->data = data;
+  watch->next = core->watchpoints;
+  core->watchpoints = watch;
+  sim_core_map_update_watched (sd, map);
+  return watch;
+}
+#endif
+
+
+#if EXTERN_SIM_CORE_P
+void
+sim_core_watch_remove (SIM_DESC sd,
+		       sim_core_watch *watch)
+{
+  sim_core *core = STATE_CORE (sd);
+  sim_core_watch **entry;
+  for (entry = &core->watchpoints;
+       (*entry) != NULL;
+       entry = &(*entry)->next)
+    {
+      if ((*entry) == watch)
+	{
+	  unsigned map = watch->map;
+	  (*entry) = watch->next;
+	  free (watch);
+	  sim_core_map_update_watched (sd, map);
+	  return;
+	}
+    }
+}
+#endif
+
+
+#if EXTERN_SIM_CORE_P
+void
+sim_core_watch_check (sim_cpu *cpu,
+		      unsigned map,
+		      address_word addr,
+		      unsigned nr_bytes)
+{
+  SIM_DESC sd = CPU_STATE (cpu);
+  sim_core_watch *watch = STATE_CORE (sd)->watchpoints;
+  while (watch != NULL)
+    {
+      /* the handler may remove the watchpoint */
+      sim_core_watch *next = watch->next;
+      if (watch->map == map
+	  && addr <= watch->bound
+	  && addr + (nr_bytes - 1) >= watch->base)
+	watch->handler (sd, cpu, watch->data);
+      watch = next;
+    }
+}
+#endif
+
+
 STATIC_INLINE_SIM_CORE\
 (sim_core_mapping *)
 sim_core_find_mapping (sim_core_common *core,
@@ -565,6 +696,8 @@ sim_core_read_buffer (SIM_DESC sd,
 #endif
     ((unsigned_1*)buffer)[count] =
       *(unsigned_1*)sim_core_translate (mapping, raddr);
+    if (cpu != NULL && SIM_CORE_WATCHED_P (mapping, raddr))
+      sim_core_watch_check (cpu, map, raddr, 1);
     count += 1;
  }
   return count;
@@ -633,6 +766,8 @@ sim_core_write_buffer (SIM_DESC sd,
 #endif
       *(unsigned_1*)sim_core_translate (mapping, raddr) =
 	((unsigned_1*)buffer)[count];
+      if (cpu != NULL && SIM_CORE_WATCHED_P (mapping, raddr))
+	sim_core_watch_check (cpu, map, raddr, 1);
       count += 1;
     }
   return count;
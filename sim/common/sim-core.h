@@ -64,6 +64,8 @@ struct _sim_core_mapping {
 #endif
   /* tracing */
   int trace;
+  /* memory watchpoints - one flag per page, NULL when none are set */
+  unsigned char *watched;
   /* growth */
   sim_core_mapping *next;
 };
@@ -79,12 +81,34 @@ typedef struct _sim_core_common {
 } sim_core_common;
 
 
+/* Memory watchpoints.  Accesses through MAP to [BASE .. BOUND] call
+   HANDLER.  */
+
+typedef void (sim_core_watch_handler) (SIM_DESC sd, sim_cpu *cpu, void *data);
+
+typedef struct _sim_core_watch sim_core_watch;
+struct _sim_core_watch {
+  unsigned map;
+  address_word base;
+  address_word bound;
+  sim_core_watch_handler *handler;
+  void *data;
+  sim_core_watch *next;
+};
+
+/* Granularity of the per-mapping watched page flags.  */
+#ifndef SIM_CORE_WATCH_PAGE_SHIFT
+#define SIM_CORE_WATCH_PAGE_SHIFT 12
+#endif
+
+
 /* Main core structure */
 
 typedef struct _sim_core sim_core;
 struct _sim_core {
   sim_core_common common;
   address_word byte_xor; /* apply xor universally */
+  sim_core_watch *watchpoints;
 };
 
 
@@ -165,6 +189,44 @@ extern void sim_core_detach
  address_word addr);
 
 
+/* Watch accesses through MAP to the address range [BASE .. BOUND].
+
+   Every page of every mapping that the range overlaps is flagged, so
+   only accesses to those pages take the slow path that compares the
+   address against the watch list; all other accesses cost a single
+   test.  HANDLER is called, with DATA, part way through the
+   instruction making the access so it should normally just schedule
+   an event.  Returns a handle for sim_core_watch_remove.  */
+
+extern sim_core_watch *sim_core_watch_insert
+(SIM_DESC sd,
+ unsigned map,
+ address_word base,
+ address_word bound,
+ sim_core_watch_handler *handler,
+ void *data);
+
+extern void sim_core_watch_remove
+(SIM_DESC sd,
+ sim_core_watch *watch);
+
+/* Slow path: call the handler of each watchpoint that the NR_BYTES
+   access at ADDR through MAP overlaps.  */
+
+extern void sim_core_watch_check
+(sim_cpu *cpu,
+ unsigned map,
+ address_word addr,
+ unsigned nr_bytes);
+
+/* Non-zero if ADDR lies on a watched page of MAPPING.  */
+
+#define SIM_CORE_WATCHED_P(MAPPING, ADDR) \
+((MAPPING)->watched != NULL \
+ && (MAPPING)->watched[((ADDR) - (MAPPING)->base) \
+		       >> SIM_CORE_WATCH_PAGE_SHIFT])
+
+
 /* Variable sized read/write
 
    Transfer a variable sized block of raw data between the host and
@@ -185,6 +185,8 @@ sim_core_read_aligned_N(sim_cpu *cpu,
 	}
 #endif
       val = T2H_M (*(unsigned_M*) sim_core_translate (mapping, addr));
+      if (SIM_CORE_WATCHED_P (mapping, addr))
+	sim_core_watch_check (cpu, map, addr, N);
     }
   while (0);
   PROFILE_COUNT_CORE (cpu, addr, N, map);
@@ -314,6 +316,8 @@ sim_core_write_aligned_N(sim_cpu *cpu,
 	}
 #endif
       *(unsigned_M*) sim_core_translate (mapping, addr) = H2T_M (val);
+      if (SIM_CORE_WATCHED_P (mapping, addr))
+	sim_core_watch_check (cpu, map, addr, N);
     }
   while (0);
   PROFILE_COUNT_CORE (cpu, addr, N, map);
@@ -490,6 +490,27 @@ profile_printf (SIM_DESC sd, sim_cpu *cpu, const char *fmt, ...)
 
 #if WITH_PROFILE_PC_P
 
+static void
+profile_pc_free_arcs (PROFILE_DATA *data)
+{
+  unsigned i;
+  if (PROFILE_PC_ARCS (data) == NULL)
+    return;
+  for (i = 0; i < PROFILE_PC_ARC_HASH_SIZE; i++)
+    {
+      struct profile_pc_arc *arc = PROFILE_PC_ARCS (data) [i];
+      while (arc != NULL)
+	{
+	  struct profile_pc_arc *next = arc->next;
+	  free (arc);
+	  arc = next;
+	}
+    }
+  free (PROFILE_PC_ARCS (data));
+  PROFILE_PC_ARCS (data) = NULL;
+  PROFILE_PC_NR_ARCS (data) = 0;
+}
+
 static void
 profile_pc_cleanup (SIM_DESC sd)
 {
@@ -501,6 +522,7 @@ profile_pc_cleanup (SIM_DESC sd)
       if (PROFILE_PC_COUNT (data) != NULL)
 	free (PROFILE_PC_COUNT (data));
       PROFILE_PC_COUNT (data) = NULL;
+      profile_pc_free_arcs (data);
       if (PROFILE_PC_EVENT (data) != NULL)
 	sim_events_deschedule (sd, PROFILE_PC_EVENT (data));
       PROFILE_PC_EVENT (data) = NULL;
@@ -538,6 +560,49 @@ profile_pc_event (SIM_DESC sd,
     sim_events_schedule (sd, PROFILE_PC_FREQ (profile), profile_pc_event, cpu);
 }
 
+/* Record a call from FROM_PC to SELF_PC.  This is on the simulator's
+   fast path, so the arc table is a simple chained hash keyed on the
+   callee and the arc found is moved to the front of its chain.  */
+
+void
+sim_profile_record_call (sim_cpu *cpu, address_word from_pc,
+			 address_word self_pc)
+{
+  PROFILE_DATA *profile = CPU_PROFILE_DATA (cpu);
+  struct profile_pc_arc **slot;
+  struct profile_pc_arc *arc;
+  struct profile_pc_arc **prev;
+
+  if (PROFILE_PC_ARCS (profile) == NULL)
+    PROFILE_PC_ARCS (profile) =
+      NZALLOC (struct profile_pc_arc *, PROFILE_PC_ARC_HASH_SIZE);
+
+  slot = &PROFILE_PC_ARCS (profile)
+    [(self_pc ^ (self_pc >> 10)) & (PROFILE_PC_ARC_HASH_SIZE - 1)];
+  for (prev = slot; (arc = *prev) != NULL; prev = &arc->next)
+    {
+      if (arc->self_pc == self_pc && arc->from_pc == from_pc)
+	{
+	  arc->count += 1;
+	  if (prev != slot)
+	    {
+	      *prev = arc->next;
+	      arc->next = *slot;
+	      *slot = arc;
+	    }
+	  return;
+	}
+    }
+
+  arc = ZALLOC (struct profile_pc_arc);
+  arc->from_pc = from_pc;
+  arc->self_pc = self_pc;
+  arc->count = 1;
+  arc->next = *slot;
+  *slot = arc;
+  PROFILE_PC_NR_ARCS (profile) += 1;
+}
+
 static SIM_RC
 profile_pc_init (SIM_DESC sd)
 {
@@ -659,6 +724,9 @@ profile_print_pc (sim_cpu *cpu, int verbose)
     profile_printf (sd, cpu, "  Range: 0x%lx 0x%lx\n",
 		    (long) PROFILE_PC_START (profile),
 		   (long) PROFILE_PC_END (profile));
+  if (PROFILE_PC_NR_ARCS (profile) != 0)
+    profile_printf (sd, cpu, "  Call graph arcs: %s\n",
+		    COMMAS (PROFILE_PC_NR_ARCS (profile)));
 
   if (verbose && max_val != 0)
     {
@@ -689,8 +757,22 @@ profile_print_pc (sim_cpu *cpu, int verbose)
 	}
     }
 
+  if (verbose && PROFILE_PC_NR_ARCS (profile) != 0)
+    {
+      profile_printf (sd, cpu, "\n");
+      for (i = 0; i < PROFILE_PC_ARC_HASH_SIZE; ++i)
+	{
+	  struct profile_pc_arc *arc;
+	  for (arc = PROFILE_PC_ARCS (profile) [i]; arc != NULL;
+	       arc = arc->next)
+	    profile_printf (sd, cpu, "  0x%08lx -> 0x%08lx: %s\n",
+			    (long) arc->from_pc, (long) arc->self_pc,
+			    COMMAS (arc->count));
+	}
+    }
+
   /* dump the histogram to the file "gmon.out" using BSD's gprof file
-     format */
+     format, followed by any call graph arcs */
   /* Since a profile data file is in the native format of the host on
      which the profile is being, endian issues are not considered in
      the code below. */
@@ -734,9 +816,32 @@ profile_print_pc (sim_cpu *cpu, int verbose)
 	      sample = 0xffff;
 	    else
 	      sample = PROFILE_PC_COUNT (profile) [loop];
- 	    H2T (sample);
+	    H2T (sample);
 	    ok = fwrite (&sample, sizeof (sample), 1, pf);
 	  }
+	/* Each arc is written as a BSD `struct rawarc': the call site,
+	   the callee and the number of traversals.  */
+	for (loop = 0;
+	     ok && PROFILE_PC_ARCS (profile) != NULL
+	       && loop < PROFILE_PC_ARC_HASH_SIZE;
+	     loop++)
+	  {
+	    struct profile_pc_arc *arc;
+	    for (arc = PROFILE_PC_ARCS (profile) [loop];
+		 ok && arc != NULL;
+		 arc = arc->next)
+	      {
+		unsigned32 rawarc[3];
+		rawarc[0] = arc->from_pc;
+		rawarc[1] = arc->self_pc;
+		rawarc[2] = (arc->count >= 0xffffffff
+			     ? 0xffffffff : arc->count);
+		H2T (rawarc[0]);
+		H2T (rawarc[1]);
+		H2T (rawarc[2]);
+		ok = fwrite (&rawarc, sizeof (rawarc), 1, pf);
+	      }
+	  }
 	if (ok == 0)
 	  sim_io_eprintf (sd, "Failed to write to \"gmon.out\" profile file\n");
 	fclose (pf);
@@ -131,6 +131,21 @@ typedef void (PROFILE_INFO_CALLBACK_FN) (SIM_DESC, int);
 struct _sim_cpu; /* forward reference */
 typedef void (PROFILE_INFO_CPU_CALLBACK_FN) (struct _sim_cpu *cpu, int verbose);
 
+#if WITH_PROFILE_PC_P
+/* One caller -> callee arc of the PC profile's call graph.  */
+struct profile_pc_arc {
+  address_word from_pc;
+  address_word self_pc;
+  unsigned long count;
+  struct profile_pc_arc *next;
+};
+
+/* Number of hash buckets used for call graph arcs (a power of two).  */
+#ifndef PROFILE_PC_ARC_HASH_SIZE
+#define PROFILE_PC_ARC_HASH_SIZE 1024
+#endif
+#endif
+
 
 /* Struct containing most profiling data.
    It doesn't contain all profiling data because for example scache data
@@ -209,6 +224,13 @@ typedef struct {
 #define PROFILE_PC_COUNT(p) ((p)->profile_pc_count)
   sim_event *profile_pc_event;
 #define PROFILE_PC_EVENT(p) ((p)->profile_pc_event)
+  /* Call graph arcs recorded by PROFILE_CALL, hashed on the callee.
+     They are written out after the histogram in gmon.out so that
+     gprof can produce a call graph.  */
+  struct profile_pc_arc **profile_pc_arcs;
+#define PROFILE_PC_ARCS(p) ((p)->profile_pc_arcs)
+  unsigned int profile_pc_nr_arcs;
+#define PROFILE_PC_NR_ARCS(p) ((p)->profile_pc_nr_arcs)
 #endif
 
   /* Profile output goes to this or stderr if NULL.
@@ -305,8 +327,21 @@ do { \
 #define PROFILE_BRANCH_UNTAKEN(cpu)
 #endif /* ! model */
 
+/* Record a call from FROM_PC to SELF_PC in the PC profile's call graph.
+   Targets invoke this from their call instructions.  */
+#if WITH_PROFILE_PC_P
+#define PROFILE_CALL(cpu, from_pc, self_pc) \
+do { \
+  if (PROFILE_PC_P (cpu)) \
+    sim_profile_record_call (cpu, from_pc, self_pc); \
+} while (0)
+#else
+#define PROFILE_CALL(cpu, from_pc, self_pc)
+#endif /* ! pc */
+
 /* Misc. utilities.  */
 
 extern void sim_profile_print_bar (SIM_DESC, sim_cpu *, unsigned int, unsigned int, unsigned int);
+extern void sim_profile_record_call (sim_cpu *, address_word, address_word);
 
 #endif /* SIM_PROFILE_H */
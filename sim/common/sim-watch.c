@@ -100,6 +100,10 @@ do_watchpoint_delete (SIM_DESC sd,
 	  sim_watch_point *dead = (*entry);
 	  (*entry) = (*entry)->next;
 	  sim_events_deschedule (sd, dead->event);
+	  if (dead->read_watch != NULL)
+	    sim_core_watch_remove (sd, dead->read_watch);
+	  if (dead->write_watch != NULL)
+	    sim_core_watch_remove (sd, dead->write_watch);
 	  free (dead);
 	  status = SIM_RC_OK;
 	}
@@ -121,6 +125,12 @@ watchpoint_type_to_str (SIM_DESC sd,
       return "clock";
     case cycles_watchpoint:
       return "cycles";
+    case read_watchpoint:
+      return "read";
+    case write_watchpoint:
+      return "write";
+    case access_watchpoint:
+      return "access";
     case invalid_watchpoint:
     case nr_watchpoint_types:
       return "(invalid-type)";
@@ -168,6 +178,7 @@ do_watchpoint_info (SIM_DESC sd)
 
 
 static sim_event_handler handle_watchpoint;
+static sim_core_watch_handler handle_memory_watchpoint;
 
 static SIM_RC
 schedule_watchpoint (SIM_DESC sd,
@@ -199,6 +210,23 @@ schedule_watchpoint (SIM_DESC sd,
 					  handle_watchpoint,
 					  point);
       return SIM_RC_OK;
+    case read_watchpoint:
+    case write_watchpoint:
+    case access_watchpoint:
+      /* The core keeps memory watchpoints in its maps across a
+	 re-init, only (re)insert those that are missing */
+      point->event = NULL;
+      if (point->type != write_watchpoint && point->read_watch == NULL)
+	point->read_watch = sim_core_watch_insert (sd, read_map,
+						   point->arg0, point->arg1,
+						   handle_memory_watchpoint,
+						   point);
+      if (point->type != read_watchpoint && point->write_watch == NULL)
+	point->write_watch = sim_core_watch_insert (sd, write_map,
+						    point->arg0, point->arg1,
+						    handle_memory_watchpoint,
+						    point);
+      return SIM_RC_OK;
     default:
       sim_engine_abort (sd, NULL, NULL_CIA,
 			"handle_watchpoint - internal error - bad switch");
@@ -228,6 +256,18 @@ handle_watchpoint (SIM_DESC sd, void *data)
 }
 
 
+/* The core calls this part way through the instruction making the
+   access; defer the action until the instruction has completed */
+
+static void
+handle_memory_watchpoint (SIM_DESC sd, sim_cpu *cpu, void *data)
+{
+  sim_watch_point *point = (sim_watch_point *) data;
+  if (point->event == NULL)
+    point->event = sim_events_schedule (sd, 0, handle_watchpoint, point);
+}
+
+
 static SIM_RC
 do_watchpoint_create (SIM_DESC sd,
 		      watchpoint_type type,
@@ -262,7 +302,7 @@ do_watchpoint_create (SIM_DESC sd,
 
   (*point)->arg0 = strtoul (arg, &arg, 0);
   if (arg[0] == ',')
-    (*point)->arg0 = strtoul (arg, NULL, 0);
+    (*point)->arg1 = strtoul (arg + 1, NULL, 0);
   else
     (*point)->arg1 = (*point)->arg0;
 
@@ -334,6 +374,21 @@ watchpoint_option_handler (SIM_DESC sd, sim_cpu *cpu, int opt,
 	      }
 	    return SIM_RC_OK;
 	  }
+	else
+	  {
+	    watchpoint_type type;
+	    for (type = read_watchpoint; type < nr_watchpoint_types; type++)
+	      {
+		if (strcasecmp (arg, watchpoint_type_to_str (sd, type)) != 0)
+		  continue;
+		if (do_watchpoint_delete (sd, 0, type) != SIM_RC_OK)
+		  {
+		    sim_io_eprintf (sd, "No %s watchpoints found\n", arg);
+		    return SIM_RC_FAIL;
+		  }
+		return SIM_RC_OK;
+	      }
+	  }
 	sim_io_eprintf (sd, "Unknown watchpoint type `%s'\n", arg);
 	return SIM_RC_FAIL;
 
@@ -371,7 +426,8 @@ sim_watchpoint_init (SIM_DESC sd)
 static const OPTION watchpoint_options[] =
 {
   { {"watch-delete", required_argument, NULL, OPTION_WATCH_DELETE },
-      '\0', "IDENT|all|pc|cycles|clock", "Delete a watchpoint",
+      '\0', "IDENT|all|pc|cycles|clock|read|write|access",
+      "Delete a watchpoint",
       watchpoint_option_handler, NULL },
 
   { {"watch-info", no_argument, NULL, OPTION_WATCH_INFO },
@@ -451,6 +507,18 @@ sim_watchpoint_install (SIM_DESC sd)
     int_options[2].arg = "[+]MILLISECONDS";
     int_options[2].doc =
       "Watch the clock, take ACTION after MILLISECONDS (`+' for every MILLISECONDS)";
+    int_options[3].doc_name = "watch-read-ACTION";
+    int_options[3].arg = "[+]ADDRESS";
+    int_options[3].doc =
+      "Watch memory, take ACTION when ADDRESS (in range ADDRESS,ADDRESS) is read (`+' for every read)";
+    int_options[4].doc_name = "watch-write-ACTION";
+    int_options[4].arg = "[+]ADDRESS";
+    int_options[4].doc =
+      "Watch memory, take ACTION when ADDRESS (in range ADDRESS,ADDRESS) is written (`+' for every write)";
+    int_options[5].doc_name = "watch-access-ACTION";
+    int_options[5].arg = "[+]ADDRESS";
+    int_options[5].doc =
+      "Watch memory, take ACTION when ADDRESS (in range ADDRESS,ADDRESS) is accessed (`+' for every access)";
 
     sim_add_option_table (sd, NULL, int_options);
   }
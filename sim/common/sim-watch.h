@@ -26,6 +26,9 @@ typedef enum {
   pc_watchpoint,
   clock_watchpoint,
   cycles_watchpoint,
+  read_watchpoint,
+  write_watchpoint,
+  access_watchpoint,
   nr_watchpoint_types,
 } watchpoint_type;
 
@@ -39,6 +42,9 @@ struct _sim_watch_point {
   unsigned long arg0;
   unsigned long arg1;
   sim_event *event;
+  /* memory watchpoints are flagged in the core's maps */
+  sim_core_watch *read_watch;
+  sim_core_watch *write_watch;
   sim_watch_point *next;
 };
 
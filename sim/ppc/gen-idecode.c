@@ -684,6 +684,89 @@ print_idecode_body(lf *file,
 /****************************************************************/
 
 
+/* Output the main loop for a single processor.  The current
+   instruction address is kept in the local CIA and only written back
+   to PROCESSOR when events need it, so cached instructions are
+   chained one straight after the other.  */
+
+static void
+print_uniprocessor_loop(lf *file,
+			insn_table *table,
+			int can_stop)
+{
+  lf_putstr(file, "\n");
+  lf_putstr(file, "while (1) {\n");
+  lf_indent(file, +2);
+
+  if (!(code & generate_with_icache)) {
+    lf_putstr(file, "instruction_word instruction =\n");
+    lf_putstr(file, "  vm_instruction_map_read(cpu_instruction_map(processor), processor, cia);\n");
+    lf_putstr(file, "\n");
+    print_idecode_body(file, table, "cia =");;
+  }
+
+  if ((code & generate_with_icache)) {
+    lf_putstr(file, "idecode_cache *cache_entry =\n");
+    lf_putstr(file, "  cpu_icache_entry(processor, cia);\n");
+    lf_putstr(file, "if (cache_entry->address == cia) {\n");
+    lf_putstr(file, "  /* cache hit */\n");
+    lf_putstr(file, "  idecode_semantic *const semantic = cache_entry->semantic;\n");
+    lf_putstr(file, "  cia = semantic(processor, cache_entry, cia);\n");
+    /* tail */
+    if (can_stop) {
+      lf_putstr(file, "if (keep_running != NULL && !*keep_running)\n");
+      lf_putstr(file, "  cpu_halt(processor, cia, was_continuing, 0/*ignore*/);\n");
+    }
+    lf_putstr(file, "}\n");
+    lf_putstr(file, "else {\n");
+    lf_putstr(file, "  /* cache miss */\n");
+    if (!(code & generate_with_semantic_icache)) {
+      lf_indent(file, +2);
+      lf_putstr(file, "idecode_semantic *semantic;\n");
+      lf_indent(file, -2);
+    }
+    lf_putstr(file, "  instruction_word instruction =\n");
+    lf_putstr(file, "    vm_instruction_map_read(cpu_instruction_map(processor), processor, cia);\n");
+    lf_putstr(file, "  if (WITH_MON != 0)\n");
+    lf_putstr(file, "    mon_event(mon_event_icache_miss, processor, cia);\n");
+    if ((code & generate_with_semantic_icache)) {
+      lf_putstr(file, "{\n");
+      lf_indent(file, +2);
+      print_idecode_body(file, table, "cia =");
+      lf_indent(file, -2);
+      lf_putstr(file, "}\n");
+    }
+    else {
+      print_idecode_body(file, table, "semantic =");
+      lf_putstr(file, "  cia = semantic(processor, cache_entry, cia);\n");
+    }
+    lf_putstr(file, "}\n");
+  }
+
+  /* events */
+  lf_putstr(file, "\n");
+  lf_putstr(file, "/* process any events */\n");
+  lf_putstr(file, "if (WITH_EVENTS) {\n");
+  lf_putstr(file, "  if (event_queue_tick(events)) {\n");
+  lf_putstr(file, "    cpu_set_program_counter(processor, cia);\n");
+  lf_putstr(file, "    event_queue_process(events);\n");
+  lf_putstr(file, "    cia = cpu_get_program_counter(processor);\n");
+  lf_putstr(file, "  }\n");
+  lf_putstr(file, "}\n");
+
+  /* tail */
+  if (can_stop) {
+    lf_putstr(file, "\n");
+    lf_putstr(file, "/* abort if necessary */\n");
+    lf_putstr(file, "if (keep_running != NULL && !*keep_running)\n");
+    lf_putstr(file, "  cpu_halt(processor, cia, was_continuing, 0/*not important*/);\n");
+  }
+
+  lf_indent(file, -2);
+  lf_putstr(file, "}\n");
+}
+
+
 static void
 print_run_until_stop_body(lf *file,
 			  insn_table *table,
@@ -792,76 +875,7 @@ print_run_until_stop_body(lf *file,
     lf_putstr(file, "processor = processors[0];\n");
     lf_putstr(file, "cia = cpu_get_program_counter(processor);\n");
 
-    lf_putstr(file, "\n");
-    lf_putstr(file, "while (1) {\n");
-    lf_indent(file, +2);
-
-    if (!(code & generate_with_icache)) {
-      lf_putstr(file, "instruction_word instruction =\n");
-      lf_putstr(file, "  vm_instruction_map_read(cpu_instruction_map(processor), processor, cia);\n");
-      lf_putstr(file, "\n");
-      print_idecode_body(file, table, "cia =");;
-    }
-
-    if ((code & generate_with_icache)) {
-      lf_putstr(file, "idecode_cache *cache_entry =\n");
-      lf_putstr(file, "  cpu_icache_entry(processor, cia);\n");
-      lf_putstr(file, "if (cache_entry->address == cia) {\n");
-      lf_putstr(file, "  /* cache hit */\n");
-      lf_putstr(file, "  idecode_semantic *const semantic = cache_entry->semantic;\n");
-      lf_putstr(file, "  cia = semantic(processor, cache_entry, cia);\n");
-      /* tail */
-      if (can_stop) {
-	lf_putstr(file, "if (keep_running != NULL && !*keep_running)\n");
-	lf_putstr(file, "  cpu_halt(processor, cia, was_continuing, 0/*ignore*/);\n");
-      }
-      lf_putstr(file, "}\n");
-      lf_putstr(file, "else {\n");
-      lf_putstr(file, "  /* cache miss */\n");
-      if (!(code & generate_with_semantic_icache)) {
-	lf_indent(file, +2);
-	lf_putstr(file, "idecode_semantic *semantic;\n");
-	lf_indent(file, -2);
-      }
-      lf_putstr(file, "  instruction_word instruction =\n");
-      lf_putstr(file, "    vm_instruction_map_read(cpu_instruction_map(processor), processor, cia);\n");
-      lf_putstr(file, "  if (WITH_MON != 0)\n");
-      lf_putstr(file, "    mon_event(mon_event_icache_miss, processor, cia);\n");
-      if ((code & generate_with_semantic_icache)) {
-	lf_putstr(file, "{\n");
-	lf_indent(file, +2);
-	print_idecode_body(file, table, "cia =");
-	lf_indent(file, -2);
-	lf_putstr(file, "}\n");
-      }
-      else {
-	print_idecode_body(file, table, "semantic =");
-	lf_putstr(file, "  cia = semantic(processor, cache_entry, cia);\n");
-      }
-      lf_putstr(file, "}\n");
-    }
-
-    /* events */
-    lf_putstr(file, "\n");
-    lf_putstr(file, "/* process any events */\n");
-    lf_putstr(file, "if (WITH_EVENTS) {\n");
-    lf_putstr(file, "  if (event_queue_tick(events)) {\n");
-    lf_putstr(file, "    cpu_set_program_counter(processor, cia);\n");
-    lf_putstr(file, "    event_queue_process(events);\n");
-    lf_putstr(file, "    cia = cpu_get_program_counter(processor);\n");
-    lf_putstr(file, "  }\n");
-    lf_putstr(file, "}\n");
-
-    /* tail */
-    if (can_stop) {
-      lf_putstr(file, "\n");
-      lf_putstr(file, "/* abort if necessary */\n");
-      lf_putstr(file, "if (keep_running != NULL && !*keep_running)\n");
-      lf_putstr(file, "  cpu_halt(processor, cia, was_continuing, 0/*not important*/);\n");
-    }
-
-    lf_indent(file, -2);
-    lf_putstr(file, "}\n");
+    print_uniprocessor_loop(file, table, can_stop);
   }
     
   if (generate_smp) {
@@ -888,6 +902,23 @@ print_run_until_stop_body(lf *file,
     lf_putstr(file, "  ASSERT(current_cpu >= -1 && current_cpu < nr_cpus);\n");
     lf_putstr(file, "}\n");
     
+    lf_putstr(file, "\n");
+    lf_putstr(file, "/* with only one cpu there is nothing to rotate between, so run\n");
+    lf_putstr(file, "   it as a uniprocessor; after a restart the clock is next */\n");
+    lf_putstr(file, "if (nr_cpus == 1) {\n");
+    lf_indent(file, +2);
+    lf_putstr(file, "cpu *processor = processors[0];\n");
+    lf_putstr(file, "unsigned_word cia;\n");
+    lf_putstr(file, "if (WITH_EVENTS && current_cpu == 0) {\n");
+    lf_putstr(file, "  if (event_queue_tick(events)) {\n");
+    lf_putstr(file, "    event_queue_process(events);\n");
+    lf_putstr(file, "  }\n");
+    lf_putstr(file, "}\n");
+    lf_putstr(file, "cia = cpu_get_program_counter(processor);\n");
+    print_uniprocessor_loop(file, table, can_stop);
+    lf_indent(file, -2);
+    lf_putstr(file, "}\n");
+
 
     lf_putstr(file, "\n");
     lf_putstr(file, "while (1) {\n");
@@ -49,6 +49,9 @@ static unsigned char **pt[L1_LEN];
 static unsigned char **ptr[L1_LEN];
 static RX_Opcode_Decoded ***ptdc[L1_LEN];
 
+/* The longest RX instruction, in bytes.  */
+#define MAX_INSN_BYTES 8
+
 /* [ get=0/put=1 ][ byte size ] */
 static unsigned int mem_counters[2][5];
 
@@ -73,6 +76,34 @@ init_mem (void)
   memset (mem_counters, 0, sizeof (mem_counters));
 }
 
+/* Discard the cached decoding of any instruction that overlaps the
+   byte at instruction address ADDRESS.  Instructions may start up to
+   MAX_INSN_BYTES - 1 bytes earlier, possibly on the previous page.  */
+
+static void
+invalidate_decode_cache (unsigned long address)
+{
+  int i;
+
+  for (i = 0; i < MAX_INSN_BYTES; i++)
+    {
+      unsigned long start = address - i;
+      int pt1 = (start >> (L2_BITS + OFF_BITS)) & ((1 << L1_BITS) - 1);
+      int pt2 = (start >> OFF_BITS) & ((1 << L2_BITS) - 1);
+      int pto = start & ((1 << OFF_BITS) - 1);
+      RX_Opcode_Decoded **dc;
+
+      if (ptdc[pt1] == NULL || ptdc[pt1][pt2] == NULL)
+	continue;
+      dc = &ptdc[pt1][pt2][pto];
+      if (*dc != NULL && (*dc)->n_bytes > i)
+	{
+	  free (*dc);
+	  *dc = NULL;
+	}
+    }
+}
+
 unsigned char *
 rx_mem_ptr (unsigned long address, enum mem_ptr_action action)
 {
@@ -111,13 +142,26 @@ rx_mem_ptr (unsigned long address, enum mem_ptr_action action)
 
       /* The instruction decoder doesn't store it's decoded instructions
          at word swapped addresses.  Therefore, when clearing the decode
-	 cache, we have to account for that here.  */
+	 cache, we have to account for that here.  A cached instruction
+	 that merely contains the byte is stale too, not only one that
+	 starts there; look back through the page for those, and only
+	 take the slow path when they might start on the previous
+	 page.  */
       pto_dc = pto ^ (rx_big_endian ? 3 : 0);
-      if (ptdc[pt1][pt2][pto_dc])
+      if (pto_dc >= MAX_INSN_BYTES - 1)
 	{
-	  free (ptdc[pt1][pt2][pto_dc]);
-	  ptdc[pt1][pt2][pto_dc] = NULL;
+	  RX_Opcode_Decoded **dc = ptdc[pt1][pt2] + pto_dc;
+	  int i;
+
+	  for (i = 0; i < MAX_INSN_BYTES; i++)
+	    if (dc[-i] != NULL && dc[-i]->n_bytes > i)
+	      {
+		free (dc[-i]);
+		dc[-i] = NULL;
+	      }
 	}
+      else
+	invalidate_decode_cache ((address & NONPAGE_MASK) | pto_dc);
     }
 
   if (action == MPA_CONTENT_TYPE)